@@ -0,0 +1,147 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdlib>
+
+#include <paramset.hpp>
+
+#include "string_util.hpp"
+
+#include "history.hpp"
+
+using namespace resembla;
+
+// previous locale-dependent conversions, kept as a baseline
+std::wstring mbs_to_wstring(const std::string& src)
+{
+    std::wstring dest(src.size(), L'\0');
+    dest.resize(std::mbstowcs(&dest[0], src.c_str(), src.size()));
+    return dest;
+}
+
+std::string wcs_to_string(const std::wstring& src)
+{
+    std::string dest(src.size() * sizeof(wchar_t), '\0');
+    dest.resize(std::wcstombs(&dest[0], src.c_str(), src.size() * sizeof(wchar_t)));
+    return dest;
+}
+
+int main(int argc, char* argv[])
+{
+    History history;
+    init_locale();
+
+    paramset::definitions defs = {
+        {"col", 0, {"col"}, "col", 'i', "column number of text in tab-separated lines. use whole string of line if col=0"},
+        {"repeat", 1000000, {"repeat"}, "repeat", 'r', "number of texts to convert with each implementation"},
+        {"conf_path", "", "config", 'c', "config file path"}
+    };
+    paramset::manager pm(defs);
+    try{
+        pm.load(argc, argv, "config");
+        std::string path = pm.rest.size() > 0 ? pm.rest[0] : "";
+        size_t col = pm.get<int>("col");
+        size_t repeat = pm.get<int>("repeat");
+
+        std::vector<std::string> texts;
+        std::istream* is = path.empty() ? &std::cin : new std::ifstream(path);
+        while(is->good()){
+            std::string line;
+            std::getline(*is, line);
+            if(is->eof()){
+                break;
+            }
+            else if(line.empty()){
+                continue;
+            }
+
+            if(col == 0){
+                texts.push_back(line);
+            }
+            else{
+                auto columns = split(line, column_delimiter<>());
+                if(col - 1 < columns.size()){
+                    texts.push_back(columns[col - 1]);
+                }
+            }
+        }
+        if(is != &std::cin){
+            delete is;
+        }
+        if(texts.empty()){
+            throw std::runtime_error("no text");
+        }
+        std::vector<std::wstring> wtexts;
+        for(const auto& text: texts){
+            wtexts.push_back(cast_string<std::wstring>(text));
+        }
+        std::cout << "corpus size: " << texts.size() << std::endl;
+        history.record("loading", 1);
+
+        size_t total = 0;
+        for(size_t i = 0; i < repeat; ++i){
+            total += mbs_to_wstring(texts[i % texts.size()]).size();
+        }
+        std::cout << "mbstowcs: " << total << " letters" << std::endl;
+        history.record("mbstowcs", repeat);
+
+        total = 0;
+        for(size_t i = 0; i < repeat; ++i){
+            total += cast_string<std::wstring>(texts[i % texts.size()]).size();
+        }
+        std::cout << "string to wstring: " << total << " letters" << std::endl;
+        history.record("string-to-wstring", repeat);
+
+        // converts into one buffer as MeCab callbacks do
+        total = 0;
+        std::wstring buffer;
+        for(size_t i = 0; i < repeat; ++i){
+            const auto& text = texts[i % texts.size()];
+            cast_string(text.data(), text.data() + text.size(), buffer);
+            total += buffer.size();
+        }
+        std::cout << "range to wstring: " << total << " letters" << std::endl;
+        history.record("range-to-wstring", repeat);
+
+        total = 0;
+        for(size_t i = 0; i < repeat; ++i){
+            total += wcs_to_string(wtexts[i % wtexts.size()]).size();
+        }
+        std::cout << "wcstombs: " << total << " bytes" << std::endl;
+        history.record("wcstombs", repeat);
+
+        total = 0;
+        for(size_t i = 0; i < repeat; ++i){
+            total += cast_string<std::string>(wtexts[i % wtexts.size()]).size();
+        }
+        std::cout << "wstring to string: " << total << " bytes" << std::endl;
+        history.record("wstring-to-string", repeat);
+    }
+    catch(const std::exception& e){
+        std::cerr << "error: " << e.what() << std::endl;
+        exit(1);
+    }
+
+    history.dump(std::cout, true, true);
+
+    return 0;
+}
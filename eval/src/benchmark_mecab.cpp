@@ -0,0 +1,140 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include <paramset.hpp>
+
+#include "measure/word_preprocessor.hpp"
+#include "measure/pronunciation_preprocessor.hpp"
+#include "string_util.hpp"
+
+#include "history.hpp"
+
+using namespace resembla;
+
+// parses repeat texts in total on thread_num threads, which share one preprocessor
+template<typename Preprocessor>
+size_t benchmark(const Preprocessor& preprocess, const std::vector<string_type>& texts,
+        size_t repeat, size_t thread_num)
+{
+    std::vector<size_t> lengths(thread_num, 0);
+    std::vector<std::thread> threads;
+    for(size_t t = 0; t < thread_num; ++t){
+        threads.emplace_back([&, t](){
+            for(size_t i = t; i < repeat; i += thread_num){
+                lengths[t] += preprocess(texts[i % texts.size()]).size();
+            }
+        });
+    }
+    for(auto& thread: threads){
+        thread.join();
+    }
+
+    size_t total = 0;
+    for(auto length: lengths){
+        total += length;
+    }
+    return total;
+}
+
+int main(int argc, char* argv[])
+{
+    History history;
+    init_locale();
+
+    paramset::definitions defs = {
+        {"col", 0, {"col"}, "col", 'i', "column number of text in tab-separated lines. use whole string of line if col=0"},
+        {"repeat", 100000, {"repeat"}, "repeat", 'r', "number of texts to parse with each number of threads"},
+        {"max_thread_num", 0, {"max_thread_num"}, "max-thread-num", 't', "max number of threads (0: number of cores)"},
+        {"mecab_options", "", {"mecab_options"}, "mecab-options", 'm', "MeCab options"},
+        {"mecab_feature_pos", 7, {"mecab_feature_pos"}, "mecab-feature-pos", 'p', "position of pronunciation in MeCab features"},
+        {"conf_path", "", "config", 'c', "config file path"}
+    };
+    paramset::manager pm(defs);
+    try{
+        pm.load(argc, argv, "config");
+        std::string path = pm.rest.size() > 0 ? pm.rest[0] : "";
+        size_t col = pm.get<int>("col");
+        size_t repeat = pm.get<int>("repeat");
+        size_t max_thread_num = pm.get<int>("max_thread_num");
+        if(max_thread_num == 0){
+            max_thread_num = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        std::vector<string_type> texts;
+        std::istream* is = path.empty() ? &std::cin : new std::ifstream(path);
+        while(is->good()){
+            std::string line;
+            std::getline(*is, line);
+            if(is->eof()){
+                break;
+            }
+            else if(line.empty()){
+                continue;
+            }
+
+            if(col == 0){
+                texts.push_back(cast_string<string_type>(line));
+            }
+            else{
+                auto columns = split(line, column_delimiter<>());
+                if(col - 1 < columns.size()){
+                    texts.push_back(cast_string<string_type>(columns[col - 1]));
+                }
+            }
+        }
+        if(is != &std::cin){
+            delete is;
+        }
+        if(texts.empty()){
+            throw std::runtime_error("no text");
+        }
+        std::cout << "corpus size: " << texts.size() << std::endl;
+        history.record("loading", 1);
+
+        WordPreprocessor<string_type> word_preprocessor(pm.get<std::string>("mecab_options"));
+        PronunciationPreprocessor pronunciation_preprocessor(pm.get<std::string>("mecab_options"),
+                pm.get<int>("mecab_feature_pos"));
+        history.record("preprocess", 1);
+
+        // average time per text with each number of threads is shown in the history
+        for(size_t thread_num = 1; thread_num <= max_thread_num; thread_num *= 2){
+            std::cout << "words, " << thread_num << " threads: " <<
+                benchmark(word_preprocessor, texts, repeat, thread_num) << " words" << std::endl;
+            history.record("words-" + std::to_string(thread_num), repeat);
+
+            std::cout << "pronunciation, " << thread_num << " threads: " <<
+                benchmark(pronunciation_preprocessor, texts, repeat, thread_num) << " letters" << std::endl;
+            history.record("pronunciation-" + std::to_string(thread_num), repeat);
+        }
+    }
+    catch(const std::exception& e){
+        std::cerr << "error: " << e.what() << std::endl;
+        exit(1);
+    }
+
+    history.dump(std::cout, true, true);
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+#include <paramset.hpp>
+
+#include "measure/edit_distance.hpp"
+#include "measure/kana_mismatch_cost.hpp"
+#include "measure/romaji_mismatch_cost.hpp"
+#include "string_util.hpp"
+
+#include "history.hpp"
+
+using namespace resembla;
+
+// computes edit distances between repeat texts and the whole corpus with each mismatch cost
+template<typename ScoreFunction>
+double benchmark(const ScoreFunction& score, const std::vector<string_type>& texts, size_t repeat)
+{
+    double total = 0.0;
+    for(size_t i = 0; i < repeat; ++i){
+        const auto& query = texts[i % texts.size()];
+        for(const auto& text: texts){
+            total += score(query, text);
+        }
+    }
+    return total;
+}
+
+int main(int argc, char* argv[])
+{
+    History history;
+    init_locale();
+
+    paramset::definitions defs = {
+        {"col", 0, {"col"}, "col", 'i', "column number of text in tab-separated lines. use whole string of line if col=0"},
+        {"repeat", 10, {"repeat"}, "repeat", 'r', "number of queries"},
+        {"kana_mismatch_cost_path", "../../example/conf/kana_mismatch_cost.tsv", {"kana_mismatch_cost_path"}, "kana-mismatch-cost", 'k', "kana mismatch cost file path"},
+        {"romaji_mismatch_cost_path", "../../example/conf/romaji_mismatch_cost.tsv", {"romaji_mismatch_cost_path"}, "romaji-mismatch-cost", 'R', "romaji mismatch cost file path"},
+        {"case_mismatch_cost", 0.1, {"case_mismatch_cost"}, "case-mismatch-cost", 'C', "cost of case mismatch in romaji"},
+        {"conf_path", "", "config", 'c', "config file path"}
+    };
+    paramset::manager pm(defs);
+    try{
+        pm.load(argc, argv, "config");
+        std::string path = pm.rest.size() > 0 ? pm.rest[0] : "";
+        size_t col = pm.get<int>("col");
+        size_t repeat = pm.get<int>("repeat");
+
+        std::vector<string_type> texts;
+        std::istream* is = path.empty() ? &std::cin : new std::ifstream(path);
+        while(is->good()){
+            std::string line;
+            std::getline(*is, line);
+            if(is->eof()){
+                break;
+            }
+            else if(line.empty()){
+                continue;
+            }
+
+            if(col == 0){
+                texts.push_back(cast_string<string_type>(line));
+            }
+            else{
+                auto columns = split(line, column_delimiter<>());
+                if(col - 1 < columns.size()){
+                    texts.push_back(cast_string<string_type>(columns[col - 1]));
+                }
+            }
+        }
+        if(is != &std::cin){
+            delete is;
+        }
+        if(texts.empty()){
+            throw std::runtime_error("no text");
+        }
+        std::cout << "corpus size: " << texts.size() << std::endl;
+        history.record("loading", 1);
+
+        EditDistance<KanaMismatchCost<string_type>> kana_edit_distance(
+                KanaMismatchCost<string_type>(pm.get<std::string>("kana_mismatch_cost_path")));
+        EditDistance<RomajiMismatchCost> romaji_edit_distance(
+                RomajiMismatchCost(pm.get<std::string>("romaji_mismatch_cost_path"), pm.get<double>("case_mismatch_cost")));
+        history.record("preprocess", 1);
+
+        std::cout << "kana total score: " << benchmark(kana_edit_distance, texts, repeat) << std::endl;
+        history.record("kana", repeat * texts.size());
+
+        std::cout << "romaji total score: " << benchmark(romaji_edit_distance, texts, repeat) << std::endl;
+        history.record("romaji", repeat * texts.size());
+    }
+    catch(const std::exception& e){
+        std::cerr << "error: " << e.what() << std::endl;
+        exit(1);
+    }
+
+    history.dump(std::cout, true, true);
+
+    return 0;
+}
@@ -122,6 +122,13 @@ int main(int argc, char** argv) {
         {"resembla_max_response", 20, {"resembla", "max_response"}, "max-response", 'n', "max number of responses from Resembla"},
         {"resembla_threshold", 0.2, {"resembla", "threshold"}, "threshold", 't', "measure for scoring"},
         {"resembla_max_reranking_num", 1000, {"resembla", "max_reranking_num"}, "max-reranking-num", 'r', "max number of reranking texts in Resembla"},
+        {"resembla_num_threads", 0, {"resembla", "num_threads"}, "num-threads", 0, "number of worker threads (0: number of hardware threads)"},
+        {"resembla_parallel_reranking", false, {"resembla", "parallel_reranking"}, "parallel-reranking", 0, "score candidates on worker threads"},
+        {"resembla_min_parallel_reranking_num", 200, {"resembla", "min_parallel_reranking_num"}, "min-parallel-reranking-num", 0, "min number of candidates for parallel reranking"},
+        {"resembla_query_cache_size", 16, {"resembla", "query_cache_size"}, "query-cache-size", 0, "max size of cache for preprocessed queries per measure in MB (0: disabled)"},
+        {"resembla_response_cache_size", 0, {"resembla", "response_cache_size"}, "response-cache-size", 0, "max number of cached responses (0: disabled)"},
+        {"resembla_response_cache_ttl", 3600.0, {"resembla", "response_cache_ttl"}, "response-cache-ttl", 0, "lifetime of cached responses in seconds (0: unlimited)"},
+        {"resembla_weight_bits", 0, {"resembla", "weight_bits"}, "weight-bits", 0, "store weights of weighted measures as 16 or 32-bit fixed-point numbers (0: double)"},
         {"simstring_measure_str", "cosine", {"simstring", "measure"}, "simstring-measure", 's', "SimString measure"},
         {"simstring_threshold", 0.2, {"simstring", "threshold"}, "simstring-threshold", 'T', "SimString threshold"},
         {"index_romaji_mecab_options", "", {"index", "romaji", "mecab_options"}, "index-romaji-mecab-options", 0, "MeCab options for romaji indexer"},
@@ -144,6 +151,7 @@ int main(int argc, char** argv) {
         {"wped_mecab_options", "", {"weighted_pronunciation_edit_distance", "mecab_options"}, "wped-mecab-options", 0, "MeCab options for weighted pronunciation edit distance"},
         {"wped_mecab_feature_pos", 7, {"weighted_pronunciation_edit_distance", "mecab_feature_pos"}, "wped-mecab-feature-pos", 0, "Position of pronunciation in feature for weighted pronunciation edit distance"},
         {"wped_mecab_pronunciation_of_marks", "", {"weighted_pronunciation_edit_distance", "mecab_pronunciation_of_marks"}, "wped-mecab-pronunciation-of-marks", 0, "pronunciation in MeCab features when input is a mark"},
+        {"wped_ascii_without_mecab", false, {"weighted_pronunciation_edit_distance", "ascii_without_mecab"}, "wped-ascii-without-mecab", 0, "convert ASCII texts as they are without MeCab"},
         {"wped_base_weight", 1L, {"weighted_pronunciation_edit_distance", "base_weight"}, "wped-base-weight", 0, "base weight for weighted pronunciation edit distance"},
         {"wped_delete_insert_ratio", 10L, {"weighted_pronunciation_edit_distance", "delete_insert_ratio"}, "wped-del-ins-ratio", 0, "cost ratio of deletion and insertion for weighted pronunciation edit distance"},
         {"wped_letter_weight_path", "", {"weighted_pronunciation_edit_distance", "letter_weight_path"}, "wped-letter-weight-path", 0, "weights of kana letters for weighted pronunciation edit distance"},
@@ -154,6 +162,7 @@ int main(int argc, char** argv) {
         {"wred_mecab_options", "", {"weighted_romaji_edit_distance", "mecab_options"}, "wred-mecab-options", 0, "MeCab options for weighted romaji edit distance"},
         {"wred_mecab_feature_pos", 7, {"weighted_romaji_edit_distance", "mecab_feature_pos"}, "wred-mecab-feature-pos", 0, "Position of pronunciation in feature for weighted romaji edit distance"},
         {"wred_mecab_pronunciation_of_marks", "", {"weighted_romaji_edit_distance", "mecab_pronunciation_of_marks"}, "wred-mecab-pronunciation-of-marks", 0, "pronunciation in MeCab features when input is a mark"},
+        {"wred_ascii_without_mecab", false, {"weighted_romaji_edit_distance", "ascii_without_mecab"}, "wred-ascii-without-mecab", 0, "convert ASCII texts as they are without MeCab"},
         {"wred_base_weight", 1L, {"weighted_romaji_edit_distance", "base_weight"}, "wred-base-weight", 0, "base weight for weighted romaji edit distance"},
         {"wred_delete_insert_ratio", 10L, {"weighted_romaji_edit_distance", "delete_insert_ratio"}, "wred-del-ins-ratio", 0, "cost ratio of deletion and insertion for weighted romaji edit distance"},
         {"wred_uppercase_coefficient", 1L, {"weighted_romaji_edit_distance", "uppercase_coefficient"}, "wred-uppercase-coefficient", 0, "coefficient for uppercase letters for weighted romaji edit distance"},
@@ -167,6 +176,7 @@ int main(int argc, char** argv) {
 
         {"km_simstring_threshold", -1, {"keyword_match", "simstring_threshold"}, "km-simstring-threshold", 0, "SimString threshold for keyword match"},
         {"km_max_reranking_num", -1, {"keyword_match", "max_reranking_num"}, "km-max-reranking-num", 0, "max number of reranking texts for keyword match"},
+        {"km_max_error_ratio", 0.0, {"keyword_match", "max_error_ratio"}, "km-max-error-ratio", 0, "max ratio of errors to length of keyword in approximate keyword match (0: exact match)"},
         {"km_ensemble_weight", 0.2, {"keyword_match", "ensemble_weight"}, "km-ensemble-weight", 0, "weight coefficient for keyword match in ensemble mode"},
         {"ensemble_simstring_threshold", -1, {"ensemble", "simstring_threshold"}, "ensemble-simstring-threshold", 0, "SimString threshold for ensemble"},
         {"ensemble_max_candidate", 100, {"ensemble", "max_candidate"}, "ensemble-max-candidate", 0, "max number of candidates for ensemble method"},
@@ -280,6 +290,13 @@ int main(int argc, char** argv) {
             std::cerr << "    measure=" << pm.get<std::string>("resembla_measure") << std::endl;
             std::cerr << "    threshold=" << pm.get<double>("resembla_threshold") << std::endl;
             std::cerr << "    max_reranking_num=" << pm.get<int>("resembla_max_reranking_num") << std::endl;
+            std::cerr << "    num_threads=" << pm.get<int>("resembla_num_threads") << std::endl;
+            std::cerr << "    parallel_reranking=" << (pm.get<bool>("resembla_parallel_reranking") ? "true" : "false") << std::endl;
+            std::cerr << "    min_parallel_reranking_num=" << pm.get<int>("resembla_min_parallel_reranking_num") << std::endl;
+            std::cerr << "    query_cache_size=" << pm.get<int>("resembla_query_cache_size") << std::endl;
+            std::cerr << "    response_cache_size=" << pm.get<int>("resembla_response_cache_size") << std::endl;
+            std::cerr << "    response_cache_ttl=" << pm.get<double>("resembla_response_cache_ttl") << std::endl;
+            std::cerr << "    weight_bits=" << pm.get<int>("resembla_weight_bits") << std::endl;
             if(use_ensemble){
                 std::cerr << "  Ensemble:" << std::endl;
                 std::cerr << "    simstring_threshold=" << pm.get<double>("ensemble_simstring_threshold") << std::endl;
@@ -311,6 +328,7 @@ int main(int argc, char** argv) {
                     std::cerr << "    mecab_options=" << pm.get<std::string>("wped_mecab_options") << std::endl;
                     std::cerr << "    mecab_feature_pos=" << pm.get<int>("wped_mecab_feature_pos") << std::endl;
                     std::cerr << "    mecab_pronunciation_of_marks=" << pm.get<std::string>("wped_mecab_pronunciation_of_marks") << std::endl;
+                    std::cerr << "    ascii_without_mecab=" << (pm.get<bool>("wped_ascii_without_mecab") ? "true" : "false") << std::endl;
                     std::cerr << "    base_weight=" << pm.get<double>("wped_base_weight") << std::endl;
                     std::cerr << "    delete_insert_ratio=" << pm.get<double>("wped_delete_insert_ratio") << std::endl;
                     std::cerr << "    letter_weight_path=" << pm.get<std::string>("wped_letter_weight_path") << std::endl;
@@ -324,6 +342,7 @@ int main(int argc, char** argv) {
                     std::cerr << "    mecab_options=" << pm.get<std::string>("wred_mecab_options") << std::endl;
                     std::cerr << "    mecab_feature_pos=" << pm.get<int>("wred_mecab_feature_pos") << std::endl;
                     std::cerr << "    mecab_pronunciation_of_marks=" << pm.get<std::string>("wred_mecab_pronunciation_of_marks") << std::endl;
+                    std::cerr << "    ascii_without_mecab=" << (pm.get<bool>("wred_ascii_without_mecab") ? "true" : "false") << std::endl;
                     std::cerr << "    base_weight=" << pm.get<double>("wred_base_weight") << std::endl;
                     std::cerr << "    delete_insert_ratio=" << pm.get<double>("wred_delete_insert_ratio") << std::endl;
                     std::cerr << "    uppercase_coefficient=" << pm.get<double>("wred_uppercase_coefficient") << std::endl;
@@ -339,6 +358,7 @@ int main(int argc, char** argv) {
                     std::cerr << "  Keyword matching:" << std::endl;
                     std::cerr << "    simstring_threshold=" << pm.get<double>("km_simstring_threshold") << std::endl;
                     std::cerr << "    max_reranking_num=" << pm.get<int>("km_max_reranking_num") << std::endl;
+                    std::cerr << "    max_error_ratio=" << pm.get<double>("km_max_error_ratio") << std::endl;
                     std::cerr << "    ensemble_weight=" << pm.get<double>("km_ensemble_weight") << std::endl;
                 }
                 else if(measure == svr){
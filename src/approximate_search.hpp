@@ -0,0 +1,117 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_APPROXIMATE_SEARCH_HPP
+#define RESEMBLA_APPROXIMATE_SEARCH_HPP
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include "pattern_match_vector.hpp"
+
+namespace resembla {
+
+// finds substrings of texts within k edits (Levenshtein distance) from a pattern by Myers' bit-parallel
+// algorithm, where matches can start at any position of texts. each character of a text costs
+// a few word operations per block of the pattern
+template<typename string_type, typename bitvector_type = uint64_t>
+class ApproximateSearch
+{
+public:
+    ApproximateSearch(const string_type& pattern): pattern_length(pattern.length()), PM(pattern) {}
+
+    // true if a substring of text is within max_distance edits from the pattern
+    bool find(const string_type& text, size_t max_distance) const
+    {
+        if(pattern_length <= max_distance){
+            return true;
+        }
+
+        const size_t blocks = PM.blocks();
+        const auto high_bit = bitvector_type{1} << (PM.BLOCK_WIDTH - 1);
+        const auto last_bit = bitvector_type{1} << ((pattern_length - 1) % PM.BLOCK_WIDTH);
+
+        // vertical deltas of the current column, which are all +1 at first.
+        // they are kept on the stack unless the pattern is long
+        bitvector_type fixed_deltas[2 * FIXED_BLOCKS];
+        std::vector<bitvector_type> allocated_deltas;
+        bitvector_type* Pv = fixed_deltas;
+        if(blocks > FIXED_BLOCKS){
+            allocated_deltas.resize(2 * blocks);
+            Pv = allocated_deltas.data();
+        }
+        bitvector_type* Mv = Pv + blocks;
+        std::fill(Pv, Pv + blocks, ~bitvector_type{0});
+        std::fill(Mv, Mv + blocks, bitvector_type{0});
+        size_t distance = pattern_length;
+        for(auto c: text){
+            const auto& Eqc = PM[c];
+
+            // the first row is always 0, since matches can start anywhere
+            int carry = 0;
+            for(size_t b = 0; b < blocks; ++b){
+                auto Eq = Eqc[b];
+                auto Xv = Eq | Mv[b];
+                if(carry < 0){
+                    Eq |= 1;
+                }
+                auto Xh = (((Eq & Pv[b]) + Pv[b]) ^ Pv[b]) | Eq;
+                auto Ph = Mv[b] | ~(Xh | Pv[b]);
+                auto Mh = Pv[b] & Xh;
+
+                if(b + 1 == blocks){
+                    if(Ph & last_bit){
+                        ++distance;
+                    }
+                    else if(Mh & last_bit){
+                        --distance;
+                    }
+                }
+
+                int next_carry = (Ph & high_bit) ? 1 : (Mh & high_bit) ? -1 : 0;
+                Ph <<= 1;
+                Mh <<= 1;
+                if(carry < 0){
+                    Mh |= 1;
+                }
+                else if(carry > 0){
+                    Ph |= 1;
+                }
+                Pv[b] = Mh | ~(Xv | Ph);
+                Mv[b] = Ph & Xv;
+                carry = next_carry;
+            }
+
+            if(distance <= max_distance){
+                return true;
+            }
+        }
+        return false;
+    }
+
+protected:
+    static const size_t FIXED_BLOCKS = 4;
+
+    size_t pattern_length;
+    PatternMatchVector<string_type, bitvector_type> PM;
+};
+
+}
+#endif
@@ -24,12 +24,20 @@ limitations under the License.
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <utility>
 
 #include <json.hpp>
 
 #include "resembla_interface.hpp"
 #include "csv_reader.hpp"
 #include "reranker.hpp"
+#include "thread_pool.hpp"
+#include "lru_cache.hpp"
+#include "memory_usage.hpp"
+
+#ifdef DEBUG
+#include <iostream>
+#endif
 
 namespace resembla {
 
@@ -41,28 +49,38 @@ public:
             std::shared_ptr<Database> database,
             std::shared_ptr<Preprocessor> preprocess,
             std::shared_ptr<ScoreFunction> score_func,
-            size_t max_candidate = 0, const std::string& index_path = ""):
+            size_t max_candidate = 0, const std::string& index_path = "",
+            std::shared_ptr<ThreadPool> pool = nullptr,
+            std::shared_ptr<ThreadPool> reranking_pool = nullptr, size_t min_parallel_reranking_num = 0,
+            size_t query_cache_size = 0):
         database(database), preprocess(preprocess), score_func(score_func),
-        reranker(), max_candidate(max_candidate)
+        reranker(reranking_pool, min_parallel_reranking_num), max_candidate(max_candidate),
+        query_cache(query_cache_size > 0 ? std::make_shared<QueryCache>(query_cache_size) : nullptr)
     {
         if(index_path.empty()){
             return;
         }
 
-        for(const auto& columns: CsvReader<string_type>(index_path, 2)){
-            const auto& original = columns[1];
-
-            if(columns.size() > 2 && !columns[2].empty()){
-                // string => JSON => preprocessed data
-                typename Preprocessor::output_type preprocessed =
-                        nlohmann::json::parse(cast_string<std::string>(columns[2]));
-                preprocessed_corpus[original] = preprocessed;
-            }
-            else{
-                // generate preprocessed data here
-                preprocessed_corpus[original] = (*preprocess)(original, true);
-            }
-        }
+        CsvReader<string_type>(index_path, 2).load(
+            [this](const std::vector<string_type>& columns) -> std::pair<string_type, WorkData>{
+                const auto& original = columns[1];
+
+                if(columns.size() > 2 && !columns[2].empty()){
+                    // string => JSON => preprocessed data
+                    WorkData preprocessed = nlohmann::json::parse(cast_string<std::string>(columns[2]));
+                    this->intern(preprocessed, 0);
+                    return std::make_pair(original, std::move(preprocessed));
+                }
+                else{
+                    // generate preprocessed data here
+                    auto preprocessed = (*this->preprocess)(original, true);
+                    this->intern(preprocessed, 0);
+                    return std::make_pair(original, std::move(preprocessed));
+                }
+            },
+            [this](std::pair<string_type, WorkData>& row){
+                preprocessed_corpus[row.first] = std::move(row.second);
+            }, pool.get());
     }
 
     std::vector<output_type> find(const string_type& query,
@@ -76,25 +94,32 @@ public:
     std::vector<output_type> eval(const string_type& query, const std::vector<string_type>& candidates,
             double threshold = 0.0, size_t max_response = 0) const
     {
-        std::vector<std::pair<string_type, WorkData>> work;
+        // refer to preprocessed data without copying them
+        std::vector<std::pair<string_type, WorkData>> preprocessed_candidates;
+        preprocessed_candidates.reserve(candidates.size());
+        std::vector<std::pair<const string_type*, const WorkData*>> work;
+        work.reserve(candidates.size());
         for(const auto& t: candidates){
             const auto i = preprocessed_corpus.find(t);
             if(i != std::end(preprocessed_corpus)){
-                work.push_back(*i);
+                work.push_back(std::make_pair(&i->first, &i->second));
             }
             else{
-                work.push_back(std::make_pair(
+                preprocessed_candidates.push_back(std::make_pair(
                     split(t, column_delimiter<string_type::value_type>())[0],
                     (*preprocess)(t, true)));
+                const auto& p = preprocessed_candidates.back();
+                work.push_back(std::make_pair(&p.first, &p.second));
             }
         }
 
         // execute reranking
-        auto input_data = std::make_pair(query, (*preprocess)(query, false));
+        auto preprocessed_query = preprocess_query(query);
+        auto input_data = std::make_pair(&query, preprocessed_query.get());
         std::vector<output_type> response;
         for(const auto& r: reranker.rerank(input_data, std::begin(work), std::end(work),
                 *score_func, threshold, max_response)){
-            response.push_back({r.first, r.second});
+            response.push_back({*r.first, r.second});
         }
         return response;
     }
@@ -108,8 +133,39 @@ protected:
     const std::shared_ptr<Preprocessor> preprocess;
     const std::shared_ptr<ScoreFunction> score_func;
 
-    const Reranker<string_type> reranker;
+    const Reranker<const string_type*> reranker;
     const size_t max_candidate;
+
+    // preprocessed queries. memory usage of entries is limited to query_cache_size bytes
+    using QueryCache = LruCache<string_type, std::shared_ptr<const WorkData>>;
+    const std::shared_ptr<QueryCache> query_cache;
+
+    // preprocessors providing intern(data) share data among the corpus, e.g. strings of words
+    template<typename P = Preprocessor>
+    auto intern(WorkData& data, int) const -> decltype(std::declval<const P&>().intern(data), void())
+    {
+        preprocess->intern(data);
+    }
+
+    void intern(WorkData&, long) const {}
+
+    std::shared_ptr<const WorkData> preprocess_query(const string_type& query) const
+    {
+        if(query_cache == nullptr){
+            return std::make_shared<const WorkData>((*preprocess)(query, false));
+        }
+
+        std::shared_ptr<const WorkData> preprocessed;
+        if(!query_cache->get(query, preprocessed)){
+            preprocessed = std::make_shared<const WorkData>((*preprocess)(query, false));
+            query_cache->put(query, preprocessed, memory_usage(query) + memory_usage(*preprocessed));
+        }
+#ifdef DEBUG
+        std::cerr << "DEBUG: " << "query cache: hits=" << query_cache->hits() << ", misses=" << query_cache->misses() <<
+            ", hit_ratio=" << query_cache->hit_ratio() << std::endl;
+#endif
+        return preprocessed;
+    }
 };
 
 }
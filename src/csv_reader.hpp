@@ -23,8 +23,11 @@ limitations under the License.
 #include <string>
 #include <vector>
 #include <fstream>
+#include <stdexcept>
+#include <type_traits>
 
 #include "string_util.hpp"
+#include "thread_pool.hpp"
 
 namespace resembla {
 
@@ -75,17 +78,7 @@ public:
                 return *this;
             }
 
-            if(raw_line.empty()){
-                return this->operator++();
-            }
-
-            auto line = cast_string<string_type>(raw_line);
-            if(!comment_str.empty() && line.compare(0, 1, comment_str) == 0){
-                return this->operator++();
-            }
-
-            columns = split(line, delimiter);
-            if(columns.size() < min_columns){
+            if(!parse(raw_line, min_columns, delimiter, comment_str, columns)){
                 return this->operator++();
             }
 
@@ -107,6 +100,79 @@ public:
         std::vector<string_type> columns;
     };
 
+    // convert a raw line to columns. returns false if the line has to be skipped
+    static bool parse(const std::string& raw_line, size_t min_columns, symbol_type delimiter,
+            const string_type& comment_str, std::vector<string_type>& columns)
+    {
+        if(raw_line.empty()){
+            return false;
+        }
+
+        auto line = cast_string<string_type>(raw_line);
+        if(!comment_str.empty() && line.compare(0, 1, comment_str) == 0){
+            return false;
+        }
+
+        columns = split(line, delimiter);
+        return columns.size() >= min_columns;
+    }
+
+    // read all rows, convert them with parse_row on pool and pass the results to merge in the original order.
+    // rows are processed sequentially without pool
+    template<typename RowParser, typename RowMerger>
+    void load(RowParser parse_row, RowMerger merge, ThreadPool* pool = nullptr,
+            size_t chunk_size = DEFAULT_CHUNK_SIZE) const
+    {
+        if(pool == nullptr){
+            for(const auto& columns: *this){
+                auto row = parse_row(columns);
+                merge(row);
+            }
+            return;
+        }
+
+        std::ifstream ifs(file_path);
+        if(ifs.fail()){
+            throw std::runtime_error("input file is not available: " + file_path);
+        }
+        string_type comment_str = comment_symbol == static_cast<symbol_type>(0) ?
+            string_type(0) : string_type(1, comment_symbol);
+
+        // read a block of lines at once to limit memory usage
+        using row_type = typename std::result_of<RowParser(const std::vector<string_type>&)>::type;
+        size_t block_size = chunk_size * (pool->size() + 1) * 4;
+        std::vector<std::string> raw_lines;
+        std::vector<std::vector<row_type>> chunks;
+        bool available = !ifs.eof();
+        while(available){
+            raw_lines.clear();
+            while(raw_lines.size() < block_size){
+                std::string raw_line;
+                std::getline(ifs, raw_line);
+                if(!(available = !ifs.eof())){
+                    break;
+                }
+                raw_lines.push_back(std::move(raw_line));
+            }
+
+            chunks.assign((raw_lines.size() + chunk_size - 1) / chunk_size, std::vector<row_type>());
+            pool->parallel_for(raw_lines.size(), chunk_size, [&](size_t begin, size_t end){
+                auto& rows = chunks[begin / chunk_size];
+                std::vector<string_type> columns;
+                for(size_t i = begin; i < end; ++i){
+                    if(parse(raw_lines[i], min_columns, delimiter, comment_str, columns)){
+                        rows.push_back(parse_row(columns));
+                    }
+                }
+            });
+            for(auto& rows: chunks){
+                for(auto& row: rows){
+                    merge(row);
+                }
+            }
+        }
+    }
+
     iterator begin() const
     {
         return iterator(file_path, min_columns, delimiter, comment_symbol);
@@ -118,6 +184,8 @@ public:
     }
 
 protected:
+    static const size_t DEFAULT_CHUNK_SIZE = 256;
+
     std::string file_path;
     size_t min_columns;
     symbol_type delimiter;
@@ -22,9 +22,10 @@ limitations under the License.
 
 #include <string>
 #include <vector>
-#include <map>
 #include <algorithm>
 
+#include "pattern_match_vector.hpp"
+
 #ifdef DEBUG
 #include <iostream>
 #include "string_util.hpp"
@@ -42,20 +43,17 @@ struct Eliminator
     using size_type = typename string_type::size_type;
     using symbol_type = typename string_type::value_type;
 
-    Eliminator(const string_type& pattern): pattern(pattern)
+    Eliminator(const string_type& pattern): pattern(pattern), pattern_length(pattern.length()), PM(pattern)
     {
         if(pattern.empty()){
             return;
         }
 
-        pattern_length = pattern.length();
-        block_size = ((pattern_length - 1) >> bitOffset<bitvector_type>()) + 1;
+        block_size = PM.blocks();
         rest_bits = pattern_length - (block_size - 1) * bitWidth<bitvector_type>();
         sink = bitvector_type{1} << (rest_bits - 1);
         VP0 = (bitvector_type{1} << rest_bits) - 1;
 
-        constructPM();
-        zeroes.resize(block_size, 0);
         work.resize(block_size);
     }
 
@@ -104,14 +102,12 @@ struct Eliminator
 protected:
     string_type pattern;
     size_type pattern_length;
-    symbol_type c_min, c_max;
     size_type block_size;
     size_type rest_bits;
     bitvector_type sink;
     bitvector_type VP0;
 
-    std::vector<std::pair<symbol_type, std::vector<bitvector_type>>> PM;
-    std::vector<bitvector_type> zeroes;
+    PatternMatchVector<string_type, bitvector_type> PM;
 
     struct WorkData
     {
@@ -134,77 +130,6 @@ protected:
         return 8 * sizeof(Integer);
     }
 
-    static constexpr int bitOffset(int w)
-    {
-        return w < 2 ? 0 : (bitOffset(w >> 1) + 1);
-    }
-
-    template<typename Integer> static constexpr int bitOffset()
-    {
-        return bitOffset(bitWidth<Integer>());
-    }
-
-    template<typename key_type, typename value_type>
-    const value_type& findValue(const std::vector<std::pair<key_type, value_type>>& data,
-            const key_type c, const value_type& default_value) const
-    {
-        if(c < c_min || c_max < c){
-            return default_value;
-        }
-        else if(c == c_min){
-            return PM.front().second;
-        }
-        else if(c == c_max){
-            return PM.back().second;
-        }
-
-        size_type l = 1, r = data.size() - 1;
-        while(r - l > 8){
-            auto i = (l + r) / 2;
-            if(data[i].first < c){
-                l = i + 1;
-            }
-            else if(data[i].first > c){
-                r = i;
-            }
-            else{
-                return data[i].second;
-            }
-        }
-
-        for(size_type i = l; i < r; ++i){
-            if(data[i].first == c){
-                return data[i].second;
-            }
-        }
-
-        return default_value;
-    }
-
-    void constructPM()
-    {
-        std::map<symbol_type, std::vector<bitvector_type>> PM_work;
-        for(size_type i = 0; i < block_size - 1; ++i){
-            for(size_type j = 0; j < bitWidth<bitvector_type>(); ++j){
-                if(PM_work[pattern[i * bitWidth<bitvector_type>() + j]].empty()){
-                    PM_work[pattern[i * bitWidth<bitvector_type>() + j]].resize(block_size, 0);
-                }
-                PM_work[pattern[i * bitWidth<bitvector_type>() + j]][i] |= bitvector_type{1} << j;
-            }
-        }
-        for(size_type i = 0; i < rest_bits; ++i){
-            if(PM_work[pattern[(block_size - 1) * bitWidth<bitvector_type>() + i]].empty()){
-                PM_work[pattern[(block_size - 1) * bitWidth<bitvector_type>() + i]].resize(block_size, 0);
-            }
-            PM_work[pattern[(block_size - 1) * bitWidth<bitvector_type>() + i]].back() |= bitvector_type{1} << i;
-        }
-
-        PM.resize(PM_work.size());
-        std::copy(std::begin(PM_work), std::end(PM_work), std::begin(PM));
-        c_min = PM.front().first;
-        c_max = PM.back().first;
-    }
-
     distance_type distance_sp(const string_type& text)
     {
         auto& w = work.front();
@@ -213,7 +138,7 @@ protected:
 
         distance_type D = pattern_length;
         for(auto c: text){
-            auto X = findValue(PM, c, zeroes).front() | w.VN;
+            auto X = PM[c].front() | w.VN;
 
             w.D0 = ((w.VP + (X & w.VP)) ^ w.VP) | X;
             w.HP = w.VN | ~(w.VP | w.D0);
@@ -244,7 +169,7 @@ protected:
 
         distance_type D = pattern_length;
         for(auto c: text){
-            const auto& PMc = findValue(PM, c, zeroes);
+            const auto& PMc = PM[c];
             for(size_type r = 0; r < block_size; ++r){
                 auto& w = work[r];
                 auto X = PMc[r];
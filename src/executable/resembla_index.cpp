@@ -17,6 +17,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -55,7 +56,8 @@ using namespace resembla;
 template<typename Indexer, typename Preprocessor>
 void create_index(const std::string& corpus_path, const std::string& db_path, const std::string& index_path,
         int n, std::shared_ptr<Indexer> index_func, std::shared_ptr<Preprocessor> preprocess,
-        size_t text_col, size_t features_col, std::shared_ptr<StringNormalizer> normalize)
+        size_t text_col, size_t features_col, std::shared_ptr<StringNormalizer> normalize,
+        const std::string& header = "")
 {
     constexpr auto delimiter = column_delimiter<string_type::value_type>();
     std::unordered_map<string_type, std::set<string_type>> inserted;
@@ -83,6 +85,9 @@ void create_index(const std::string& corpus_path, const std::string& db_path, co
 
     std::basic_ofstream<string_type::value_type> ofs;
     ofs.open(index_path);
+    if(!header.empty()){
+        ofs << cast_string<string_type>(header) << std::endl;
+    }
     for(auto p: inserted){
         for(auto original: p.second){
             auto columns = split(original, delimiter);
@@ -103,6 +108,51 @@ void create_index(const std::string& corpus_path, const std::string& db_path, co
     }
 }
 
+// weighted measures whose weights are stored as weight_type
+template<typename weight_type>
+void create_weighted_index(const paramset::manager& pm, const measure resembla_measure,
+        const std::string& corpus_path, const std::string& db_path, const std::string& index_path,
+        std::shared_ptr<StringNormalizer> normalize)
+{
+    if(resembla_measure == weighted_word_edit_distance){
+        auto indexer = std::make_shared<AsIsPreprocessor<string_type>>();
+        auto preprocessor = std::make_shared<WeightedSequenceBuilder<WordPreprocessor<string_type>, WordWeight, weight_type>>(
+            std::make_shared<WordPreprocessor<string_type>>(pm.get<std::string>("wwed_mecab_options"),
+                9, Word<string_type>::used_feature_columns()),
+            std::make_shared<WordWeight>(pm.get<double>("wwed_base_weight"),
+                pm.get<double>("wwed_delete_insert_ratio"), pm.get<double>("wwed_noun_coefficient"),
+                pm.get<double>("wwed_verb_coefficient"), pm.get<double>("wwed_adj_coefficient")));
+        create_index(corpus_path, db_path, index_path, pm.get<int>("wwed_simstring_ngram_unit"),
+                indexer, preprocessor, pm.get<int>("text_col"), pm.get<int>("features_col"), normalize,
+                weight_format_header<weight_type>());
+    }
+    else if(resembla_measure == weighted_pronunciation_edit_distance){
+        auto indexer = std::make_shared<PronunciationPreprocessor>(pm.get<std::string>("wped_mecab_options"),
+                pm.get<int>("wped_mecab_feature_pos"), pm.get<std::string>("wped_mecab_pronunciation_of_marks"),
+                pm.get<bool>("wped_ascii_without_mecab"));
+        auto preprocessor = std::make_shared<WeightedSequenceBuilder<PronunciationPreprocessor, LetterWeight<string_type>, weight_type>>(
+            indexer,
+            std::make_shared<LetterWeight<string_type>>(pm.get<double>("wped_base_weight"),
+                pm.get<double>("wped_delete_insert_ratio"), pm.get<std::string>("wped_letter_weight_path")));
+        create_index(corpus_path, db_path, index_path, pm.get<int>("wped_simstring_ngram_unit"),
+                indexer, preprocessor, pm.get<int>("text_col"), pm.get<int>("features_col"), normalize,
+                weight_format_header<weight_type>());
+    }
+    else if(resembla_measure == weighted_romaji_edit_distance){
+        auto indexer = std::make_shared<RomajiPreprocessor>(pm.get<std::string>("wred_mecab_options"),
+            pm.get<int>("wred_mecab_feature_pos"), pm.get<std::string>("wred_mecab_pronunciation_of_marks"),
+            false, pm.get<bool>("wred_ascii_without_mecab"));
+        auto preprocessor = std::make_shared<WeightedSequenceBuilder<RomajiPreprocessor, RomajiWeight, weight_type>>(
+            indexer,
+            std::make_shared<RomajiWeight>(pm.get<double>("wred_base_weight"), pm.get<double>("wred_delete_insert_ratio"),
+                pm.get<double>("wred_uppercase_coefficient"), pm.get<double>("wred_lowercase_coefficient"),
+                pm.get<double>("wred_vowel_coefficient"), pm.get<double>("wred_consonant_coefficient")));
+        create_index(corpus_path, db_path, index_path, pm.get<int>("wred_simstring_ngram_unit"),
+                indexer, preprocessor, pm.get<int>("text_col"), pm.get<int>("features_col"), normalize,
+                weight_format_header<weight_type>());
+    }
+}
+
 int main(int argc, char* argv[])
 {
     init_locale();
@@ -113,6 +163,7 @@ int main(int argc, char* argv[])
         {"index_romaji_mecab_feature_pos", 7, {"index", "romaji", "mecab_feature_pos"}, "index-romaji-mecab-feature-pos", 0, "Position of pronunciation in feature for romaji indexer"},
         {"index_romaji_mecab_pronunciation_of_marks", "", {"index", "romaji", "mecab_pronunciation_of_marks"}, "index-romaji-mecab-pronunciation-of-marks", 0, "pronunciation in MeCab features when input is a mark"},
         {"resembla_measure", STR(weighted_word_edit_distance), {"resembla", "measure"}, "measure", 'm', "measure for scoring"},
+        {"resembla_weight_bits", 0, {"resembla", "weight_bits"}, "weight-bits", 0, "store weights of weighted measures as 16 or 32-bit fixed-point numbers (0: double)"},
         {"ed_simstring_ngram_unit", -1, {"edit_distance", "simstring_ngram_unit"}, "ed-simstring-ngram-unit", 0, "Unit of N-gram for input text"},
         {"wwed_simstring_ngram_unit", -1, {"weighted_word_edit_distance", "simstring_ngram_unit"}, "wwed-simstring-ngram-unit", 0, "Unit of N-gram for input text"},
         {"wwed_mecab_options", "", {"weighted_word_edit_distance", "mecab_options"}, "wwed-mecab-options", 0, "MeCab options for weighted word edit distance"},
@@ -125,6 +176,7 @@ int main(int argc, char* argv[])
         {"wped_mecab_options", "", {"weighted_pronunciation_edit_distance", "mecab_options"}, "wped-mecab-options", 0, "MeCab options for weighted pronunciation edit distance"},
         {"wped_mecab_feature_pos", 7, {"weighted_pronunciation_edit_distance", "mecab_feature_pos"}, "wped-mecab-feature-pos", 0, "Position of pronunciation in feature for weighted pronunciation edit distance"},
         {"wped_mecab_pronunciation_of_marks", "", {"weighted_pronunciation_edit_distance", "mecab_pronunciation_of_marks"}, "wped-mecab-pronunciation-of-marks", 0, "pronunciation in MeCab features when input is a mark"},
+        {"wped_ascii_without_mecab", false, {"weighted_pronunciation_edit_distance", "ascii_without_mecab"}, "wped-ascii-without-mecab", 0, "convert ASCII texts as they are without MeCab"},
         {"wped_base_weight", 1L, {"weighted_pronunciation_edit_distance", "base_weight"}, "wped-base-weight", 0, "base weight for weighted pronunciation edit distance"},
         {"wped_delete_insert_ratio", 10L, {"weighted_pronunciation_edit_distance", "delete_insert_ratio"}, "wped-del-ins-ratio", 0, "cost ratio of deletion and insertion for weighted pronunciation edit distance"},
         {"wped_letter_weight_path", "", {"weighted_pronunciation_edit_distance", "letter_weight_path"}, "wped-letter-weight-path", 0, "weights of kana letters for weighted pronunciation edit distance"},
@@ -132,6 +184,7 @@ int main(int argc, char* argv[])
         {"wred_mecab_options", "", {"weighted_romaji_edit_distance", "mecab_options"}, "wred-mecab-options", 0, "MeCab options for weighted romaji edit distance"},
         {"wred_mecab_feature_pos", 7, {"weighted_romaji_edit_distance", "mecab_feature_pos"}, "wred-mecab-feature-pos", 0, "Position of pronunciation in feature for weighted romaji edit distance"},
         {"wred_mecab_pronunciation_of_marks", "", {"weighted_romaji_edit_distance", "mecab_pronunciation_of_marks"}, "wred-mecab-pronunciation-of-marks", 0, "pronunciation in MeCab features when input is a mark"},
+        {"wred_ascii_without_mecab", false, {"weighted_romaji_edit_distance", "ascii_without_mecab"}, "wred-ascii-without-mecab", 0, "convert ASCII texts as they are without MeCab"},
         {"wred_base_weight", 1L, {"weighted_romaji_edit_distance", "base_weight"}, "wred-base-weight", 0, "base weight for weighted romaji edit distance"},
         {"wred_delete_insert_ratio", 10L, {"weighted_romaji_edit_distance", "delete_insert_ratio"}, "wred-del-ins-ratio", 0, "cost ratio of deletion and insertion for weighted romaji edit distance"},
         {"wred_uppercase_coefficient", 1L, {"weighted_romaji_edit_distance", "uppercase_coefficient"}, "wred-uppercase-coefficient", 0, "coefficient for uppercase letters for weighted romaji edit distance"},
@@ -217,6 +270,7 @@ int main(int argc, char* argv[])
             std::cerr << "    corpus_path=" << pm.get<std::string>("corpus_path") << std::endl;
             std::cerr << "    text_col=" << pm.get<int>("text_col") << std::endl;
             std::cerr << "    features_col=" << pm.get<int>("features_col") << std::endl;
+            std::cerr << "    weight_bits=" << pm.get<int>("resembla_weight_bits") << std::endl;
             std::cerr << "  SimString:" << std::endl;
             std::cerr << "    ngram_unit=" << pm.get<int>("simstring_ngram_unit") << std::endl;
             if(pm.get<bool>("normalize_text")){
@@ -247,6 +301,7 @@ int main(int argc, char* argv[])
                     std::cerr << "    mecab_options=" << pm.get<std::string>("wped_mecab_options") << std::endl;
                     std::cerr << "    mecab_feature_pos=" << pm.get<int>("wped_mecab_feature_pos") << std::endl;
                     std::cerr << "    mecab_pronunciation_of_marks=" << pm.get<std::string>("wped_mecab_pronunciation_of_marks") << std::endl;
+                    std::cerr << "    ascii_without_mecab=" << (pm.get<bool>("wped_ascii_without_mecab") ? "true" : "false") << std::endl;
                     std::cerr << "    base_weight=" << pm.get<double>("wped_base_weight") << std::endl;
                     std::cerr << "    delete_insert_ratio=" << pm.get<double>("wped_delete_insert_ratio") << std::endl;
                     std::cerr << "    letter_weight_path=" << pm.get<std::string>("wped_letter_weight_path") << std::endl;
@@ -257,6 +312,7 @@ int main(int argc, char* argv[])
                     std::cerr << "    mecab_options=" << pm.get<std::string>("wred_mecab_options") << std::endl;
                     std::cerr << "    mecab_feature_pos=" << pm.get<int>("wred_mecab_feature_pos") << std::endl;
                     std::cerr << "    mecab_pronunciation_of_marks=" << pm.get<std::string>("wred_mecab_pronunciation_of_marks") << std::endl;
+                    std::cerr << "    ascii_without_mecab=" << (pm.get<bool>("wred_ascii_without_mecab") ? "true" : "false") << std::endl;
                 }
                 else if(resembla_measure == keyword_match){
                     std::cerr << "  measure=" << STR(keyword_match) << std::endl;
@@ -290,36 +346,23 @@ int main(int argc, char* argv[])
                 create_index(corpus_path, db_path, index_path, pm.get<int>("ed_simstring_ngram_unit"),
                         preprocessor, preprocessor, pm.get<int>("text_col"), pm.get<int>("features_col"), normalize);
             }
-            else if(resembla_measure == weighted_word_edit_distance){
-                auto indexer = std::make_shared<AsIsPreprocessor<string_type>>();
-                auto preprocessor = std::make_shared<WeightedSequenceBuilder<WordPreprocessor<string_type>, WordWeight>>(
-                    std::make_shared<WordPreprocessor<string_type>>(pm.get<std::string>("wwed_mecab_options")),
-                    std::make_shared<WordWeight>(pm.get<double>("wwed_base_weight"),
-                        pm.get<double>("wwed_delete_insert_ratio"), pm.get<double>("wwed_noun_coefficient"),
-                        pm.get<double>("wwed_verb_coefficient"), pm.get<double>("wwed_adj_coefficient")));
-                create_index(corpus_path, db_path, index_path, pm.get<int>("wwed_simstring_ngram_unit"),
-                        indexer, preprocessor, pm.get<int>("text_col"), pm.get<int>("features_col"), normalize);
-            }
-            else if(resembla_measure == weighted_pronunciation_edit_distance){
-                auto indexer = std::make_shared<PronunciationPreprocessor>(pm.get<std::string>("wped_mecab_options"),
-                        pm.get<int>("wped_mecab_feature_pos"), pm.get<std::string>("wped_mecab_pronunciation_of_marks"));
-                auto preprocessor = std::make_shared<WeightedSequenceBuilder<PronunciationPreprocessor, LetterWeight<string_type>>>(
-                    indexer,
-                    std::make_shared<LetterWeight<string_type>>(pm.get<double>("wped_base_weight"),
-                        pm.get<double>("wped_delete_insert_ratio"), pm.get<std::string>("wped_letter_weight_path")));
-                create_index(corpus_path, db_path, index_path, pm.get<int>("wped_simstring_ngram_unit"),
-                        indexer, preprocessor, pm.get<int>("text_col"), pm.get<int>("features_col"), normalize);
-            }
-            else if(resembla_measure == weighted_romaji_edit_distance){
-                auto indexer = std::make_shared<RomajiPreprocessor>(pm.get<std::string>("wred_mecab_options"),
-                    pm.get<int>("wred_mecab_feature_pos"), pm.get<std::string>("wred_mecab_pronunciation_of_marks"));
-                auto preprocessor = std::make_shared<WeightedSequenceBuilder<RomajiPreprocessor, RomajiWeight>>(
-                    indexer,
-                    std::make_shared<RomajiWeight>(pm.get<double>("wred_base_weight"), pm.get<double>("wred_delete_insert_ratio"),
-                        pm.get<double>("wred_uppercase_coefficient"), pm.get<double>("wred_lowercase_coefficient"),
-                        pm.get<double>("wred_vowel_coefficient"), pm.get<double>("wred_consonant_coefficient")));
-                create_index(corpus_path, db_path, index_path, pm.get<int>("wred_simstring_ngram_unit"),
-                        indexer, preprocessor, pm.get<int>("text_col"), pm.get<int>("features_col"), normalize);
+            else if(resembla_measure == weighted_word_edit_distance ||
+                    resembla_measure == weighted_pronunciation_edit_distance ||
+                    resembla_measure == weighted_romaji_edit_distance){
+                switch(pm.get<int>("resembla_weight_bits")){
+                    case 0:
+                        create_weighted_index<double>(pm, resembla_measure, corpus_path, db_path, index_path, normalize);
+                        break;
+                    case 16:
+                        create_weighted_index<int16_t>(pm, resembla_measure, corpus_path, db_path, index_path, normalize);
+                        break;
+                    case 32:
+                        create_weighted_index<int32_t>(pm, resembla_measure, corpus_path, db_path, index_path, normalize);
+                        break;
+                    default:
+                        throw std::invalid_argument("unsupported number of bits of weights: " +
+                            std::to_string(pm.get<int>("resembla_weight_bits")));
+                }
             }
             else if(resembla_measure == keyword_match){
                 auto indexer = std::make_shared<AsIsPreprocessor<string_type>>();
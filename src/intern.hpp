@@ -0,0 +1,71 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_INTERN_HPP
+#define RESEMBLA_INTERN_HPP
+
+#include <functional>
+#include <unordered_set>
+#include <mutex>
+
+namespace resembla {
+
+// hash function for sequences such as vectors of strings
+template<typename sequence_type>
+struct SequenceHash
+{
+    size_t operator()(const sequence_type& s) const
+    {
+        std::hash<typename sequence_type::value_type> hash;
+        size_t h = s.size();
+        for(const auto& e: s){
+            h ^= hash(e) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        }
+        return h;
+    }
+};
+
+// unique copies of values. equal values are interned to the same address,
+// so that they can be compared as pointers. interned values are kept while the pool exists
+template<typename T, typename Hash = std::hash<T>>
+class InternPool
+{
+public:
+    // returns the address of the unique copy of value
+    const T* intern(const T& value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_pool);
+        return &*pool.insert(value).first;
+    }
+
+    // returns the address of the copy of value, or nullptr if value is not interned.
+    // lookups need no lock, so that they must not run while other threads intern values
+    const T* find(const T& value) const
+    {
+        auto i = pool.find(value);
+        return i != std::end(pool) ? &*i : nullptr;
+    }
+
+protected:
+    std::unordered_set<T, Hash> pool;
+    std::mutex mutex_pool;
+};
+
+}
+#endif
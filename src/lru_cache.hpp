@@ -0,0 +1,147 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_LRU_CACHE_HPP
+#define RESEMBLA_LRU_CACHE_HPP
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+
+namespace resembla {
+
+// thread-safe LRU cache. entries are distributed to shards by their hash values to reduce lock contention,
+// and each shard evicts least recently used entries when total cost of its entries exceeds its capacity
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache
+{
+public:
+    LruCache(size_t max_cost, size_t num_shards = DEFAULT_NUM_SHARDS):
+        shards(std::max(std::min(num_shards, max_cost), static_cast<size_t>(1))),
+        max_shard_cost(max_cost / shards.size()), hash(),
+        hit_count(0), miss_count(0)
+    {}
+
+    bool get(const Key& key, Value& value)
+    {
+        auto& shard = shard_of(key);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto i = shard.index.find(key);
+            if(i != std::end(shard.index)){
+                shard.entries.splice(std::begin(shard.entries), shard.entries, i->second);
+                value = i->second->value;
+                ++hit_count;
+                return true;
+            }
+        }
+        ++miss_count;
+        return false;
+    }
+
+    void put(const Key& key, const Value& value, size_t cost)
+    {
+        if(cost > max_shard_cost){
+            return;
+        }
+
+        auto& shard = shard_of(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto i = shard.index.find(key);
+        if(i != std::end(shard.index)){
+            shard.cost -= i->second->cost;
+            shard.entries.erase(i->second);
+            shard.index.erase(i);
+        }
+
+        shard.entries.push_front({key, value, cost});
+        shard.index[key] = std::begin(shard.entries);
+        shard.cost += cost;
+        while(shard.cost > max_shard_cost){
+            const auto& last = shard.entries.back();
+            shard.cost -= last.cost;
+            shard.index.erase(last.key);
+            shard.entries.pop_back();
+        }
+    }
+
+    void clear()
+    {
+        for(auto& shard: shards){
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.entries.clear();
+            shard.index.clear();
+            shard.cost = 0;
+        }
+    }
+
+    size_t hits() const
+    {
+        return hit_count;
+    }
+
+    size_t misses() const
+    {
+        return miss_count;
+    }
+
+    double hit_ratio() const
+    {
+        size_t h = hit_count, m = miss_count;
+        return h + m == 0 ? 0.0 : static_cast<double>(h) / (h + m);
+    }
+
+protected:
+    static const size_t DEFAULT_NUM_SHARDS = 16;
+
+    struct Entry
+    {
+        Key key;
+        Value value;
+        size_t cost;
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::list<Entry> entries;
+        std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index;
+        size_t cost = 0;
+    };
+
+    std::vector<Shard> shards;
+    const size_t max_shard_cost;
+    const Hash hash;
+
+    std::atomic<size_t> hit_count;
+    std::atomic<size_t> miss_count;
+
+    Shard& shard_of(const Key& key)
+    {
+        return shards[hash(key) % shards.size()];
+    }
+};
+
+}
+#endif
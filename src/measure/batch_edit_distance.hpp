@@ -0,0 +1,355 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_BATCH_EDIT_DISTANCE_HPP
+#define RESEMBLA_BATCH_EDIT_DISTANCE_HPP
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "fixed_point.hpp"
+
+namespace resembla {
+
+// cells of tables in single precision. scores differ from those in double precision by rounding errors
+struct FloatLane
+{
+    using cell_type = float;
+
+    // maximum error of distances relative to the sum of weights
+    static constexpr double TOLERANCE = 1e-5;
+
+    static constexpr double MAX_CELL = std::numeric_limits<double>::infinity();
+
+    static cell_type weight(double w)
+    {
+        return static_cast<cell_type>(w);
+    }
+
+    static cell_type indel(double w)
+    {
+        return static_cast<cell_type>(w);
+    }
+
+    static cell_type cost(double c)
+    {
+        return static_cast<cell_type>(c);
+    }
+};
+
+// cells of tables in 32-bit integers for quantized weights, computed in the same units as FixedPoint.
+// scores are exactly the same as those computed one by one unless cells overflow
+template<typename weight_type>
+struct FixedPointLane
+{
+    using cell_type = int32_t;
+
+    static constexpr double TOLERANCE = 0.0;
+
+    static constexpr double MAX_CELL = std::numeric_limits<cell_type>::max();
+
+    static cell_type weight(weight_type w)
+    {
+        return w;
+    }
+
+    static cell_type indel(weight_type w)
+    {
+        return static_cast<cell_type>(FixedPoint<weight_type>::indel(w));
+    }
+
+    static cell_type cost(double c)
+    {
+        return static_cast<cell_type>(std::llround(c * FixedPointScale<weight_type>::COST_SCALE));
+    }
+};
+
+// lanes to score sequences with each type of weights. 16-bit weights always fit in 32-bit lanes.
+// single precision is used only with RESEMBLA_SIMD, same as the anti-diagonal kernel
+template<typename weight_type, typename = void>
+struct BatchLane
+{};
+
+template<>
+struct BatchLane<int16_t>
+{
+    using type = FixedPointLane<int16_t>;
+};
+
+#ifdef RESEMBLA_SIMD
+template<typename weight_type>
+struct BatchLane<weight_type, typename std::enable_if<std::is_floating_point<weight_type>::value>::type>
+{
+    using type = FloatLane;
+};
+#endif
+
+// elements having a token and a weight
+struct WeightedTokenAccess
+{
+    template<typename T>
+    static auto token(const T& x) -> decltype((x.token))
+    {
+        return x.token;
+    }
+
+    template<typename T>
+    static auto weight(const T& x) -> decltype(x.weight)
+    {
+        return x.weight;
+    }
+};
+
+// elements which are tokens themselves with weight 1
+struct UnitWeightAccess
+{
+    template<typename T>
+    static const T& token(const T& x)
+    {
+        return x;
+    }
+
+    template<typename T>
+    static double weight(const T&)
+    {
+        return 1.0;
+    }
+};
+
+// tokens are kept in profiles by their order, so sequences of unordered tokens such as words are scored one by one
+template<typename Access, typename sequence_type, typename = void>
+struct has_token_order: std::false_type
+{};
+
+template<typename Access, typename sequence_type>
+struct has_token_order<Access, sequence_type, decltype(void(
+    Access::token(std::declval<const sequence_type&>()[0]) < Access::token(std::declval<const sequence_type&>()[0])))>:
+    std::true_type
+{};
+
+// scores groups of sequences against the query a at once, one sequence per lane (SWIPE).
+// costs between a and each token are computed once and kept in a profile, and the columns of
+// the profile for the tokens in the lanes are gathered before each column of the table,
+// so that the innermost loop over lanes is plain min/add/mul and vectorized by compilers.
+// substitutions cost (weight of x + weight of y) * cost(x, y) as in Distance
+template<typename Distance, typename Access, typename sequence_type, typename Lane>
+class BatchEditDistance
+{
+public:
+    static const size_t LANES = 16;
+
+    BatchEditDistance(const Distance& distance, const sequence_type& a):
+        distance(distance), a(a), n(a.size()), profile(n, 0), max_profile_cost(0),
+        weight_a(0.0), cost_a(0.0)
+    {
+        for(const auto& x: a){
+            wa.push_back(Lane::weight(Access::weight(x)));
+            ia.push_back(Lane::indel(Access::weight(x)));
+            weight_a += wa.back();
+            cost_a += ia.back();
+        }
+    }
+
+    // scores count sequences in b, which must be at most LANES. as the bounded overload of Distance,
+    // a score is exact if it is not less than min_score, and an upper bound of the score otherwise
+    void operator()(const sequence_type* const* b, size_t count, double min_score, double* scores)
+    {
+        if(n == 0){
+            for(size_t l = 0; l < count; ++l){
+                scores[l] = distance(a, *b[l]);
+            }
+            return;
+        }
+
+        // lanes are innermost. positions beyond the end of sequences have no weights and costs
+        size_t m = 0;
+        for(size_t l = 0; l < count; ++l){
+            m = std::max(m, b[l]->size());
+        }
+        wb.assign(m * LANES, 0);
+        ib.assign(m * LANES, 0);
+        columns.assign(m * LANES, 0);
+        double max_costs[LANES], max_distances[LANES], weights_b[LANES];
+        for(size_t l = 0; l < count; ++l){
+            double cost_b = 0.0;
+            weights_b[l] = 0.0;
+            for(size_t j = 0; j < b[l]->size(); ++j){
+                const auto& y = (*b[l])[j];
+                wb[j * LANES + l] = Lane::weight(Access::weight(y));
+                ib[j * LANES + l] = Lane::indel(Access::weight(y));
+                columns[j * LANES + l] = column(Access::token(y));
+                weights_b[l] += wb[j * LANES + l];
+                cost_b += ib[j * LANES + l];
+            }
+            max_costs[l] = cost_a + cost_b;
+            max_distances[l] = min_score > 0.0 ?
+                (1.0 - min_score + BOUND_TOLERANCE + Lane::TOLERANCE) * max_costs[l] :
+                std::numeric_limits<double>::infinity();
+        }
+
+        // cells never exceed the sum of costs of deletions and insertions,
+        // and substitutions add at most (sum of weights) * max_profile_cost to them
+        for(size_t l = 0; l < count; ++l){
+            if(max_costs[l] + (weight_a + weights_b[l]) * max_profile_cost > Lane::MAX_CELL){
+                for(size_t k = 0; k < count; ++k){
+                    scores[k] = score(*b[k], min_score, 0);
+                }
+                return;
+            }
+        }
+
+        // prepare work table. two columns are swapped, so that no cell is overwritten while it is read
+        previous.resize((n + 1) * LANES);
+        current.resize((n + 1) * LANES);
+        substitution.resize(n * LANES);
+        for(size_t l = 0; l < LANES; ++l){
+            current[l] = 0;
+        }
+        for(size_t i = 1; i < n + 1; ++i){
+            for(size_t l = 0; l < LANES; ++l){
+                current[i * LANES + l] = current[(i - 1) * LANES + l] + ia[i - 1];
+            }
+        }
+
+        bool done[LANES];
+        size_t num_active = 0;
+        for(size_t l = 0; l < LANES; ++l){
+            done[l] = l >= count || b[l]->empty();
+            if(l < count && b[l]->empty()){
+                scores[l] = 0.0;
+            }
+            num_active += done[l] ? 0 : 1;
+        }
+
+        // compute edit distances of all lanes
+        cell_type column_min[LANES];
+        for(size_t j = 0; j < m && num_active > 0; ++j){
+            const cell_type* wb_j = &wb[j * LANES];
+            const cell_type* ib_j = &ib[j * LANES];
+            for(size_t l = 0; l < LANES; ++l){
+                const cell_type* c = &profile[columns[j * LANES + l] * n];
+                for(size_t i = 0; i < n; ++i){
+                    substitution[i * LANES + l] = c[i];
+                }
+            }
+
+            std::swap(previous, current);
+            const cell_type* P = &previous[0];
+            cell_type* C = &current[0];
+            for(size_t l = 0; l < LANES; ++l){
+                C[l] = P[l] + ib_j[l];
+                column_min[l] = C[l];
+            }
+            for(size_t i = 1; i < n + 1; ++i){
+                const cell_type wa_i = wa[i - 1], ia_i = ia[i - 1];
+                const cell_type* s_i = &substitution[(i - 1) * LANES];
+                for(size_t l = 0; l < LANES; ++l){
+                    cell_type del = C[(i - 1) * LANES + l] + ia_i;
+                    cell_type ins = P[i * LANES + l] + ib_j[l];
+                    cell_type sub = P[(i - 1) * LANES + l] + (wa_i + wb_j[l]) * s_i[l];
+                    cell_type d = std::min(std::min(del, ins), sub);
+                    C[i * LANES + l] = d;
+                    column_min[l] = std::min(column_min[l], d);
+                }
+            }
+
+            // every alignment passes through each column
+            for(size_t l = 0; l < count; ++l){
+                if(done[l]){
+                    continue;
+                }
+                if(b[l]->size() == j + 1){
+                    scores[l] = 1.0 - static_cast<double>(C[n * LANES + l]) / max_costs[l];
+                }
+                else if(column_min[l] > max_distances[l]){
+                    scores[l] = 1.0 - max_distances[l] / max_costs[l];
+                }
+                else{
+                    continue;
+                }
+                done[l] = true;
+                --num_active;
+            }
+        }
+    }
+
+protected:
+    using cell_type = typename Lane::cell_type;
+    using token_type = typename std::decay<decltype(Access::token(std::declval<const sequence_type&>()[0]))>::type;
+
+    const Distance& distance;
+    const sequence_type& a;
+    const size_t n;
+
+    // costs between a and tokens. column 0 is for positions beyond the end of sequences.
+    // tokens are looked up for every position of candidates, so that letters are hashed
+    typename std::conditional<std::is_integral<token_type>::value,
+        std::unordered_map<token_type, size_t>, std::map<token_type, size_t>>::type column_ids;
+    std::vector<cell_type> profile;
+    cell_type max_profile_cost;
+
+    std::vector<cell_type> wa, ia;
+    double weight_a, cost_a;
+
+    // work area reused for each group
+    std::vector<cell_type> wb, ib, previous, current, substitution;
+    std::vector<size_t> columns;
+
+    // distances without the bounded overload ignore min_score
+    template<typename D = Distance>
+    auto score(const sequence_type& b, double min_score, int) const
+        -> decltype(std::declval<const D&>()(std::declval<const sequence_type&>(), b, min_score))
+    {
+        return distance(a, b, min_score);
+    }
+
+    double score(const sequence_type& b, double, long) const
+    {
+        return distance(a, b);
+    }
+
+    size_t column(const token_type& t)
+    {
+        auto p = column_ids.find(t);
+        if(p != std::end(column_ids)){
+            return p->second;
+        }
+
+        size_t id = column_ids.size() + 1;
+        column_ids.emplace(t, id);
+        for(const auto& x: a){
+            profile.push_back(Lane::cost(distance.cost(Access::token(x), t)));
+            max_profile_cost = std::max(max_profile_cost, profile.back());
+        }
+        return id;
+    }
+
+    // margin of scores to keep candidates whose score is equal to min_score in spite of rounding errors
+    static constexpr double BOUND_TOLERANCE = 1e-9;
+};
+
+}
+#endif
@@ -0,0 +1,106 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_BIT_PARALLEL_EDIT_DISTANCE_HPP
+#define RESEMBLA_BIT_PARALLEL_EDIT_DISTANCE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "../pattern_match_vector.hpp"
+
+namespace resembla {
+
+// edit distance allowing insertions and deletions of cost 1 and substitutions of cost 2,
+// which equals to n + m - 2 * LCS(a, b). the query is preprocessed once,
+// and the LCS of each text is computed by bit-parallel algorithm in O(ceil(n / w) * m)
+template<typename string_type, typename bitvector_type = uint64_t>
+class BitParallelEditDistance
+{
+public:
+    BitParallelEditDistance(const string_type& query): query_length(query.length()), PM(query) {}
+
+    // a has to be the query given to the constructor
+    double operator()(const string_type& a, const string_type& b) const
+    {
+        (void)a;
+
+        if(query_length == 0){
+            return b.empty() ? 1.0 : 0.0;
+        }
+        else if(b.empty()){
+            return 0.0;
+        }
+
+        auto total = query_length + b.length();
+        return 1.0 - static_cast<double>(total - 2 * lcs(b)) / total;
+    }
+
+protected:
+    const size_t query_length;
+    const PatternMatchVector<string_type, bitvector_type> PM;
+
+    size_t lcs(const string_type& text) const
+    {
+        if(PM.blocks() == 1){
+            // zero bits of V are matched positions of the query
+            bitvector_type V = ~bitvector_type{0};
+            for(auto c: text){
+                auto U = V & PM[c].front();
+                V = (V + U) | (V - U);
+            }
+            return count_zeroes(V, query_length);
+        }
+
+        std::vector<bitvector_type> V(PM.blocks(), ~bitvector_type{0});
+        for(auto c: text){
+            const auto& PMc = PM[c];
+            bitvector_type carry = 0;
+            for(size_t k = 0; k < V.size(); ++k){
+                auto U = V[k] & PMc[k];
+                auto X = V[k] + U + carry;
+                carry = X < V[k] || (carry && X == V[k]) ? 1 : 0;
+                V[k] = X | (V[k] - U);
+            }
+        }
+
+        const size_t block_width = 8 * sizeof(bitvector_type);
+        size_t result = 0;
+        for(size_t k = 0; k < V.size(); ++k){
+            result += count_zeroes(V[k], k + 1 < V.size() ? block_width : query_length - k * block_width);
+        }
+        return result;
+    }
+
+    // number of zero bits in lower width bits
+    static size_t count_zeroes(bitvector_type v, size_t width)
+    {
+        if(width < 8 * sizeof(bitvector_type)){
+            v |= ~bitvector_type{0} << width;
+        }
+        size_t result = 0;
+        for(v = ~v; v != 0; v &= v - 1){
+            ++result;
+        }
+        return result;
+    }
+};
+
+}
+#endif
@@ -21,8 +21,12 @@ limitations under the License.
 #define RESEMBLA_EDIT_DISTANCE_HPP
 
 #include <vector>
+#include <algorithm>
+#include <type_traits>
 
 #include "fixed_cost.hpp"
+#include "bit_parallel_edit_distance.hpp"
+#include "batch_edit_distance.hpp"
 
 namespace resembla {
 
@@ -64,6 +68,23 @@ struct EditDistance
     
         return 1.0 - D.back() / (a.size() + b.size());
     }
+
+    // with fixed costs, the query is preprocessed for bit-parallel computation that gives the same score
+    template<typename sequence_type, typename F = CostFunction>
+    typename std::enable_if<std::is_same<F, FixedCost>::value, BitParallelEditDistance<sequence_type>>::type
+    prepare(const sequence_type& a) const
+    {
+        return BitParallelEditDistance<sequence_type>(a);
+    }
+
+#ifdef RESEMBLA_SIMD
+    // scores groups of sequences against a in SIMD lanes of single precision
+    template<typename sequence_type>
+    BatchEditDistance<EditDistance, UnitWeightAccess, sequence_type, FloatLane> batch(const sequence_type& a) const
+    {
+        return BatchEditDistance<EditDistance, UnitWeightAccess, sequence_type, FloatLane>(*this, a);
+    }
+#endif
 };
 
 }
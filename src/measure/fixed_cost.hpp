@@ -29,6 +29,11 @@ struct FixedCost
     {
         return a == b ? 0.0 : 1.0;
     }
+
+    double min_mismatch_cost() const
+    {
+        return 1.0;
+    }
 };
 
 }
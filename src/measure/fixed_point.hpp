@@ -0,0 +1,134 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_FIXED_POINT_HPP
+#define RESEMBLA_FIXED_POINT_HPP
+
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+namespace resembla {
+
+// scales of quantized weights and costs. a weight w is stored as round(w * WEIGHT_SCALE),
+// and a cost c between tokens is used as round(c * COST_SCALE) / COST_SCALE
+template<typename weight_type>
+struct FixedPointScale;
+
+template<>
+struct FixedPointScale<int16_t>
+{
+    static constexpr double WEIGHT_SCALE = 128.0;
+    static constexpr int64_t COST_SCALE = 1024;
+};
+
+template<>
+struct FixedPointScale<int32_t>
+{
+    static constexpr double WEIGHT_SCALE = 65536.0;
+    static constexpr int64_t COST_SCALE = 65536;
+};
+
+// arithmetic of edit distance tables for each type of weights.
+// weights of floating point types are used as they are
+template<typename weight_type, bool = std::is_integral<weight_type>::value>
+struct FixedPoint
+{
+    using cell_type = double;
+
+    static constexpr double WEIGHT_SCALE = 1.0;
+
+    // maximum error of scores caused by rounding costs
+    static constexpr double COST_ERROR = 0.0;
+
+    static weight_type quantize(double w)
+    {
+        return static_cast<weight_type>(w);
+    }
+
+    static cell_type infinity()
+    {
+        return std::numeric_limits<cell_type>::infinity();
+    }
+
+    // cost of deletion or insertion
+    static cell_type indel(weight_type w)
+    {
+        return w;
+    }
+
+    static cell_type substitution(weight_type wa, weight_type wb, double cost)
+    {
+        return (wa + wb) * cost;
+    }
+
+    static double round_cost(double cost)
+    {
+        return cost;
+    }
+};
+
+// integral weights are fixed-point numbers, and cells of tables are integers in units of 1 / COST_SCALE.
+// scores don't depend on the scale of weights, so the error of a score comes only from rounding.
+// each weight w in [1 / WEIGHT_SCALE, max / WEIGHT_SCALE] moves by at most 0.5 / WEIGHT_SCALE and each cost
+// by at most 0.5 / COST_SCALE, so the score of sequences whose weights are at least w_min differs from
+// the one computed with double weights by at most about 1 / (w_min * WEIGHT_SCALE) + 0.5 / COST_SCALE.
+// weights out of the range are clamped
+template<typename weight_type>
+struct FixedPoint<weight_type, true>
+{
+    using cell_type = int64_t;
+
+    static constexpr double WEIGHT_SCALE = FixedPointScale<weight_type>::WEIGHT_SCALE;
+
+    static constexpr double COST_ERROR = 0.5 / FixedPointScale<weight_type>::COST_SCALE;
+
+    static weight_type quantize(double w)
+    {
+        auto q = std::llround(w * FixedPointScale<weight_type>::WEIGHT_SCALE);
+        return static_cast<weight_type>(std::min<long long>(std::max<long long>(q, 1),
+                std::numeric_limits<weight_type>::max()));
+    }
+
+    static cell_type infinity()
+    {
+        return std::numeric_limits<cell_type>::max() / 4;
+    }
+
+    static cell_type indel(weight_type w)
+    {
+        return static_cast<cell_type>(w) * FixedPointScale<weight_type>::COST_SCALE;
+    }
+
+    static cell_type substitution(weight_type wa, weight_type wb, double cost)
+    {
+        return (static_cast<cell_type>(wa) + wb) * std::llround(cost * FixedPointScale<weight_type>::COST_SCALE);
+    }
+
+    static double round_cost(double cost)
+    {
+        return static_cast<double>(std::llround(cost * FixedPointScale<weight_type>::COST_SCALE)) /
+            FixedPointScale<weight_type>::COST_SCALE;
+    }
+};
+
+}
+#endif
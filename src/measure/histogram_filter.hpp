@@ -0,0 +1,137 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_HISTOGRAM_FILTER_HPP
+#define RESEMBLA_HISTOGRAM_FILTER_HPP
+
+#include <vector>
+#include <map>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+namespace resembla {
+
+// wraps a weighted edit distance together with the token histogram of the query.
+// the histogram gives an upper bound of the score of each candidate in O(n + m),
+// which allows rerankers to discard candidates before dynamic programming
+template<typename Distance, typename sequence_type>
+class HistogramFilter
+{
+public:
+    // min_mismatch_cost has to be a lower bound of costs between different tokens
+    HistogramFilter(const Distance& distance, const sequence_type& a, double min_mismatch_cost):
+        distance(distance), min_mismatch_cost(std::min(1.0, std::max(0.0, min_mismatch_cost))),
+        query_empty(a.empty()), query_weight(0.0), query_unmatched_weight(0.0)
+    {
+        std::map<token_type, Bin> bins_work;
+        for(const auto& t: a){
+            auto& bin = bins_work[t.token];
+            ++bin.count;
+            bin.min_weight = std::min<double>(bin.min_weight, t.weight);
+            query_weight += t.weight;
+        }
+        for(const auto& p: bins_work){
+            tokens.push_back(p.first);
+            bins.push_back(p.second);
+            query_unmatched_weight += p.second.count * p.second.min_weight;
+        }
+    }
+
+    double operator()(const sequence_type& a, const sequence_type& b) const
+    {
+        return distance(a, b);
+    }
+
+    double operator()(const sequence_type& a, const sequence_type& b, double min_score) const
+    {
+        return distance(a, b, min_score);
+    }
+
+    // candidates are scored in groups if the distance supports it
+    template<typename D = Distance>
+    auto batch(const sequence_type& a) const -> decltype(std::declval<const D&>().batch(a))
+    {
+        return distance.batch(a);
+    }
+
+    // a token without identical counterparts in the other sequence is deleted, inserted or substituted,
+    // and costs at least min_mismatch_cost times its weight. a has to be the query given to the constructor
+    double upper_bound(const sequence_type& a, const sequence_type& b) const
+    {
+        (void)a;
+
+        if(query_empty){
+            return b.empty() ? 1.0 : 0.0;
+        }
+        else if(b.empty()){
+            return 0.0;
+        }
+
+        std::vector<size_t> counts(tokens.size(), 0);
+        std::vector<double> min_weights(tokens.size(), std::numeric_limits<double>::infinity());
+        double target_weight = 0.0, unmatched_weight = 0.0;
+        for(const auto& t: b){
+            target_weight += t.weight;
+            auto p = std::lower_bound(std::begin(tokens), std::end(tokens), t.token);
+            if(p == std::end(tokens) || t.token < *p){
+                unmatched_weight += t.weight;
+                continue;
+            }
+            auto k = p - std::begin(tokens);
+            ++counts[k];
+            min_weights[k] = std::min<double>(min_weights[k], t.weight);
+        }
+
+        // each token can be matched to at most min(count in a, count in b) identical tokens
+        unmatched_weight += query_unmatched_weight;
+        for(size_t k = 0; k < tokens.size(); ++k){
+            if(counts[k] == 0){
+                continue;
+            }
+            auto matched = std::min(counts[k], bins[k].count);
+            unmatched_weight -= matched * bins[k].min_weight;
+            unmatched_weight += (counts[k] - matched) * min_weights[k];
+        }
+
+        return 1.0 - min_mismatch_cost * std::max(0.0, unmatched_weight) / (query_weight + target_weight);
+    }
+
+protected:
+    using token_type = typename std::decay<decltype(std::declval<const sequence_type&>()[0].token)>::type;
+
+    struct Bin
+    {
+        size_t count = 0;
+        double min_weight = std::numeric_limits<double>::infinity();
+    };
+
+    const Distance& distance;
+    const double min_mismatch_cost;
+
+    const bool query_empty;
+    double query_weight;
+    double query_unmatched_weight;
+    std::vector<token_type> tokens;
+    std::vector<Bin> bins;
+};
+
+}
+#endif
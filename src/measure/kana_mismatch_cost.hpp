@@ -22,7 +22,8 @@ limitations under the License.
 
 #include <string>
 #include <iostream>
-#include <unordered_map>
+#include <vector>
+#include <cstdint>
 #include <algorithm>
 
 #include "../string_util.hpp"
@@ -35,22 +36,51 @@ struct KanaMismatchCost
 {
     using value_type = typename string_type::value_type;
 
-    KanaMismatchCost(const std::string& letter_similarity_file_path)
+    // costs are compiled into a dense matrix indexed by letters appearing in the file.
+    // other letters share index 0, whose costs are always 1
+    KanaMismatchCost(const std::string& letter_similarity_file_path): first_letter(0), num_letters(1), costs(1, 1.0)
     {
         if(letter_similarity_file_path.empty()){
             return;
         }
 
+        std::vector<std::pair<string_type, double>> letter_groups;
         for(const auto& columns: CsvReader<>(letter_similarity_file_path, 2)){
             auto letters = cast_string<string_type>(columns[0]);
-            const auto cost = std::stod(columns[1]);
-
             std::sort(std::begin(letters), std::end(letters));
-            for(size_t i = 0; i < letters.size() - 1; ++i){
-                string_type s(1, letters[i]);
+            letter_groups.push_back(std::make_pair(letters, std::stod(columns[1])));
+        }
+
+        // assign compact indices to code points between the smallest and the largest letters
+        value_type last_letter = 0;
+        bool found = false;
+        for(const auto& g: letter_groups){
+            for(auto c: g.first){
+                first_letter = found ? std::min(first_letter, c) : c;
+                last_letter = found ? std::max(last_letter, c) : c;
+                found = true;
+            }
+        }
+        if(!found){
+            return;
+        }
+        letter_index.assign(static_cast<size_t>(last_letter - first_letter) + 1, 0);
+        for(const auto& g: letter_groups){
+            for(auto c: g.first){
+                auto& i = letter_index[c - first_letter];
+                if(i == 0){
+                    i = static_cast<uint32_t>(num_letters++);
+                }
+            }
+        }
+
+        costs.assign(num_letters * num_letters, 1.0);
+        for(const auto& g: letter_groups){
+            const auto& letters = g.first;
+            for(size_t i = 0; i + 1 < letters.size(); ++i){
                 for(size_t j = i + 1; j < letters.size(); ++j){
-                    string_type p = s + letters[j];
-                    letter_similarities[p] = cost;
+                    auto a = index(letters[i]), b = index(letters[j]);
+                    costs[a * num_letters + b] = costs[b * num_letters + a] = g.second;
                 }
             }
         }
@@ -62,12 +92,26 @@ struct KanaMismatchCost
             return 0.0;
         }
 
-        auto p = letter_similarities.find(a < b ? string_type({a, b}) : string_type({b, a}));
-        return p != std::end(letter_similarities) ? p->second : 1.0;
+        return costs[index(a) * num_letters + index(b)];
+    }
+
+    // lower bound of costs between different letters
+    double min_mismatch_cost() const
+    {
+        return *std::min_element(std::begin(costs), std::end(costs));
     }
 
 protected:
-    std::unordered_map<string_type, double> letter_similarities;
+    value_type first_letter;
+    std::vector<uint32_t> letter_index;
+    size_t num_letters;
+    std::vector<double> costs;
+
+    size_t index(const value_type c) const
+    {
+        auto offset = static_cast<size_t>(c) - static_cast<size_t>(first_letter);
+        return offset < letter_index.size() ? letter_index[offset] : 0;
+    }
 };
 
 }
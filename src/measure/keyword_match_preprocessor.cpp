@@ -34,12 +34,11 @@ void to_json(nlohmann::json& j,
 void from_json(const nlohmann::json& j,
         typename KeywordMatchPreprocessor<AsIsPreprocessor<string_type>>::output_type& o)
 {
-    o.text = cast_string<string_type>(j.at("t").get<std::string>());
-    std::vector<std::string> keywords = j.at("k").get<std::vector<std::string>>();
-    o.keywords.clear();
-    for(const auto& k: keywords){
-        o.keywords.push_back(cast_string<string_type>(k));
+    std::vector<string_type> keywords;
+    for(const auto& k: j.at("k").get<std::vector<std::string>>()){
+        keywords.push_back(cast_string<string_type>(k));
     }
+    o = {cast_string<string_type>(j.at("t").get<std::string>()), keywords};
 }
 
 void to_json(nlohmann::json& j,
@@ -55,12 +54,11 @@ void to_json(nlohmann::json& j,
 void from_json(const nlohmann::json& j,
         typename KeywordMatchPreprocessor<RomajiPreprocessor>::output_type& o)
 {
-    o.text = cast_string<string_type>(j.at("t").get<std::string>());
-    std::vector<std::string> keywords = j.at("k").get<std::vector<std::string>>();
-    o.keywords.clear();
-    for(const auto& k: keywords){
-        o.keywords.push_back(cast_string<string_type>(k));
+    std::vector<string_type> keywords;
+    for(const auto& k: j.at("k").get<std::vector<std::string>>()){
+        keywords.push_back(cast_string<string_type>(k));
     }
+    o = {cast_string<string_type>(j.at("t").get<std::string>()), keywords};
 }
 
 }
@@ -27,6 +27,7 @@ limitations under the License.
 #include <json.hpp>
 
 #include "../string_util.hpp"
+#include "../approximate_search.hpp"
 #include "asis_preprocessor.hpp"
 #include "romaji_preprocessor.hpp"
 
@@ -46,6 +47,20 @@ public:
     {
         string_type text;
         std::vector<string_type> keywords;
+
+        // searches for each keyword, built once so that keywords are matched approximately without allocation
+        std::vector<ApproximateSearch<string_type>> patterns;
+
+        output_type() = default;
+
+        output_type(const string_type& text, const std::vector<string_type>& keywords):
+            text(text), keywords(keywords)
+        {
+            patterns.reserve(keywords.size());
+            for(const auto& keyword: keywords){
+                patterns.emplace_back(keyword);
+            }
+        }
     };
 
     KeywordMatchPreprocessor(std::shared_ptr<StringPreprocessor> preprocess): preprocess(preprocess)
@@ -21,6 +21,8 @@ limitations under the License.
 #define RESEMBLA_KEYWORD_MATCHER_HPP
 
 #include "keyword_match_preprocessor.hpp"
+#include "../suffix_automaton.hpp"
+#include "../approximate_search.hpp"
 
 #include <string>
 #include <iostream>
@@ -32,18 +34,66 @@ struct KeywordMatcher
 {
 public:
     using string_type = typename StringPreprocessor::output_type;
+    using input_type = typename KeywordMatchPreprocessor<StringPreprocessor>::output_type;
 
-    double operator()(const typename KeywordMatchPreprocessor<StringPreprocessor>::output_type& target,
-            const typename KeywordMatchPreprocessor<StringPreprocessor>::output_type& reference) const
+    // keywords match substrings of targets within floor(max_error_ratio * length of keyword) edits
+    KeywordMatcher(double max_error_ratio = 0.0): max_error_ratio(max_error_ratio) {}
+
+    // the text of target is indexed once, so that each keyword of references is found in O(length of keyword)
+    class Prepared
+    {
+    public:
+        Prepared(const input_type& target, double max_error_ratio):
+            automaton(target.text), max_error_ratio(max_error_ratio) {}
+
+        // target has to be the one given to the constructor
+        double operator()(const input_type& target, const input_type& reference) const
+        {
+            return score(target, reference, [this, &target, &reference](size_t i){
+                return automaton.contains(reference.keywords[i]) ||
+                    approximate_match(target.text, reference, i, max_error_ratio);
+            });
+        }
+
+    protected:
+        const SuffixAutomaton<string_type> automaton;
+        const double max_error_ratio;
+    };
+
+    Prepared prepare(const input_type& target) const
+    {
+        return Prepared(target, max_error_ratio);
+    }
+
+    double operator()(const input_type& target, const input_type& reference) const
+    {
+        return score(target, reference, [this, &target, &reference](size_t i){
+            return target.text.find(reference.keywords[i]) != string_type::npos ||
+                approximate_match(target.text, reference, i, max_error_ratio);
+        });
+    }
+
+protected:
+    const double max_error_ratio;
+
+    // i-th keyword of reference
+    static bool approximate_match(const string_type& text, const input_type& reference, size_t i,
+            double max_error_ratio)
+    {
+        auto max_distance = static_cast<size_t>(reference.keywords[i].length() * max_error_ratio);
+        return max_distance > 0 && reference.patterns[i].find(text, max_distance);
+    }
+
+    template<typename Contains>
+    static double score(const input_type& target, const input_type& reference, Contains contains)
     {
         // TODO: use synonyms
         if(reference.keywords.empty()){
             return 0.0;
         }
         double score = 0.0;
-        for(const auto& keyword: reference.keywords){
-            // TODO: approximate match
-            if(target.text.find(keyword) != string_type::npos){
+        for(size_t i = 0; i < reference.keywords.size(); ++i){
+            if(contains(i)){
                 score += 1.0;
             }
             else{
@@ -51,13 +101,15 @@ public:
             }
         }
 #ifdef DEBUG
-        for(const auto& keyword: reference.keywords){
-            std::cerr << (target.text.find(keyword) == string_type::npos ? "not " : "") <<
-                "matced: keyword=" << cast_string<std::string>(keyword) <<
+        for(size_t i = 0; i < reference.keywords.size(); ++i){
+            std::cerr << (contains(i) ? "" : "not ") <<
+                "matced: keyword=" << cast_string<std::string>(reference.keywords[i]) <<
                 ", target=" << cast_string<std::string>(target.text) <<
                 ", reference=" << cast_string<std::string>(reference.text) << std::endl;
         }
         std::cerr << "keyword match score=" << score / reference.keywords.size() << std::endl;
+#else
+        (void)target;
 #endif
         return score / reference.keywords.size();
     }
@@ -21,7 +21,8 @@ limitations under the License.
 #define RESEMBLA_LETTER_WEIGHT_HPP
 
 #include <string>
-#include <unordered_map>
+#include <vector>
+#include <algorithm>
 
 #include "../string_util.hpp"
 #include "../csv_reader.hpp"
@@ -34,20 +35,35 @@ struct LetterWeight
 {
     using value_type = typename string_type::value_type;
 
+    // coefficients are stored in a flat table over code points between the smallest and the largest letters in the file
     LetterWeight(double base_weight, double delete_insert_ratio,
             const std::string& letter_weight_file_path):
-        base_weight(base_weight), delete_insert_ratio(delete_insert_ratio)
+        base_weight(base_weight), delete_insert_ratio(delete_insert_ratio), first_letter(0)
     {
         if(letter_weight_file_path.empty()){
             return;
         }
 
+        std::vector<std::pair<string_type, double>> letter_groups;
+        value_type last_letter = 0;
+        bool found = false;
         for(const auto& columns: CsvReader<>(letter_weight_file_path, 2)){
             auto letters = cast_string<string_type>(columns[0]);
-            auto weight = std::stod(columns[1]);
-
             for(auto c: letters){
-                letter_weights[c] = weight;
+                first_letter = found ? std::min(first_letter, c) : c;
+                last_letter = found ? std::max(last_letter, c) : c;
+                found = true;
+            }
+            letter_groups.push_back(std::make_pair(letters, std::stod(columns[1])));
+        }
+        if(!found){
+            return;
+        }
+
+        letter_weights.assign(static_cast<size_t>(last_letter - first_letter) + 1, 1.0);
+        for(const auto& g: letter_groups){
+            for(auto c: g.first){
+                letter_weights[c - first_letter] = g.second;
             }
         }
     }
@@ -63,19 +79,35 @@ struct LetterWeight
             w *= delete_insert_ratio;
         }
 
-        auto p = letter_weights.find(c);
-        if(p != std::end(letter_weights)){
-            w *= p->second;
+        return w * coefficient(c);
+    }
+
+    // weights all letters of s at once and passes them to put in order
+    template<typename sequence_type, typename Put>
+    void weigh(const sequence_type& s, bool is_original, Put put) const
+    {
+        double w = base_weight;
+        if(is_original){
+            w *= delete_insert_ratio;
         }
 
-        return w;
+        for(const auto& c: s){
+            put(w * coefficient(c));
+        }
     }
 
 protected:
     const double base_weight;
     const double delete_insert_ratio;
 
-    std::unordered_map<value_type, double> letter_weights;
+    value_type first_letter;
+    std::vector<double> letter_weights;
+
+    double coefficient(const value_type c) const
+    {
+        auto offset = static_cast<size_t>(c) - static_cast<size_t>(first_letter);
+        return offset < letter_weights.size() ? letter_weights[offset] : 1.0;
+    }
 };
 
 }
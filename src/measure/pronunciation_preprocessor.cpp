@@ -20,196 +20,84 @@ limitations under the License.
 #include "pronunciation_preprocessor.hpp"
 
 #include <vector>
+#include <algorithm>
+#include <iterator>
+#ifdef DEBUG
+#include <iostream>
+#endif
 
 #include "../string_util.hpp"
 #include "../mecab_util.hpp"
 
 namespace resembla {
 
-const std::unordered_map<PronunciationPreprocessor::token_type, string_type>
-        PronunciationPreprocessor::KANA_MAP = {
-    {L'ぁ', L"ァ"},
-    {L'あ', L"ア"},
-    {L'ぃ', L"ィ"},
-    {L'い', L"イ"},
-    {L'ぅ', L"ゥ"},
-    {L'う', L"ウ"},
-    {L'ぇ', L"ェ"},
-    {L'え', L"エ"},
-    {L'ぉ', L"ォ"},
-    {L'お', L"オ"},
-    {L'か', L"カ"},
-    {L'が', L"ガ"},
-    {L'き', L"キ"},
-    {L'ぎ', L"ギ"},
-    {L'く', L"ク"},
-    {L'ぐ', L"グ"},
-    {L'け', L"ケ"},
-    {L'げ', L"ゲ"},
-    {L'こ', L"コ"},
-    {L'ご', L"ゴ"},
-    {L'さ', L"サ"},
-    {L'ざ', L"ザ"},
-    {L'し', L"シ"},
-    {L'じ', L"ジ"},
-    {L'す', L"ス"},
-    {L'ず', L"ズ"},
-    {L'せ', L"セ"},
-    {L'ぜ', L"ゼ"},
-    {L'そ', L"ソ"},
-    {L'ぞ', L"ゾ"},
-    {L'た', L"タ"},
-    {L'だ', L"ダ"},
-    {L'ち', L"チ"},
-    {L'ぢ', L"ヂ"},
-    {L'っ', L"ッ"},
-    {L'つ', L"ツ"},
-    {L'づ', L"ヅ"},
-    {L'て', L"テ"},
-    {L'で', L"デ"},
-    {L'と', L"ト"},
-    {L'ど', L"ド"},
-    {L'な', L"ナ"},
-    {L'に', L"ニ"},
-    {L'ぬ', L"ヌ"},
-    {L'ね', L"ネ"},
-    {L'の', L"ノ"},
-    {L'は', L"ハ"},
-    {L'ば', L"バ"},
-    {L'ぱ', L"パ"},
-    {L'ひ', L"ヒ"},
-    {L'び', L"ビ"},
-    {L'ぴ', L"ピ"},
-    {L'ふ', L"フ"},
-    {L'ぶ', L"ブ"},
-    {L'ぷ', L"プ"},
-    {L'へ', L"ヘ"},
-    {L'べ', L"ベ"},
-    {L'ぺ', L"ペ"},
-    {L'ほ', L"ホ"},
-    {L'ぼ', L"ボ"},
-    {L'ぽ', L"ポ"},
-    {L'ま', L"マ"},
-    {L'み', L"ミ"},
-    {L'む', L"ム"},
-    {L'め', L"メ"},
-    {L'も', L"モ"},
-    {L'ゃ', L"ャ"},
-    {L'や', L"ヤ"},
-    {L'ゅ', L"ュ"},
-    {L'ゆ', L"ユ"},
-    {L'ょ', L"ョ"},
-    {L'よ', L"ヨ"},
-    {L'ら', L"ラ"},
-    {L'り', L"リ"},
-    {L'る', L"ル"},
-    {L'れ', L"レ"},
-    {L'ろ', L"ロ"},
-    {L'ゎ', L"ヮ"},
-    {L'わ', L"ワ"},
-    {L'ゐ', L"イ"},
-    {L'ゑ', L"エ"},
-    {L'を', L"ヲ"},
-    {L'ん', L"ン"},
-    {L'ゔ', L"ヴ"},
-    {L'ゕ', L"ヵ"},
-    {L'ゖ', L"ヶ"},
-    {L'ゟ', L"ヨリ"},
-    {L'ゝ', L"ヽ"},
-    {L'ゞ', L"ヾ"},
-    {L'ァ', L"ァ"},
-    {L'ア', L"ア"},
-    {L'ィ', L"ィ"},
-    {L'イ', L"イ"},
-    {L'ゥ', L"ゥ"},
-    {L'ウ', L"ウ"},
-    {L'ェ', L"ェ"},
-    {L'エ', L"エ"},
-    {L'ォ', L"ォ"},
-    {L'オ', L"オ"},
-    {L'カ', L"カ"},
-    {L'ガ', L"ガ"},
-    {L'キ', L"キ"},
-    {L'ギ', L"ギ"},
-    {L'ク', L"ク"},
-    {L'グ', L"グ"},
-    {L'ケ', L"ケ"},
-    {L'ゲ', L"ゲ"},
-    {L'コ', L"コ"},
-    {L'ゴ', L"ゴ"},
-    {L'サ', L"サ"},
-    {L'ザ', L"ザ"},
-    {L'シ', L"シ"},
-    {L'ジ', L"ジ"},
-    {L'ス', L"ス"},
-    {L'ズ', L"ズ"},
-    {L'セ', L"セ"},
-    {L'ゼ', L"ゼ"},
-    {L'ソ', L"ソ"},
-    {L'ゾ', L"ゾ"},
-    {L'タ', L"タ"},
-    {L'ダ', L"ダ"},
-    {L'チ', L"チ"},
-    {L'ヂ', L"ヂ"},
-    {L'ッ', L"ッ"},
-    {L'ツ', L"ツ"},
-    {L'ヅ', L"ヅ"},
-    {L'テ', L"テ"},
-    {L'デ', L"デ"},
-    {L'ト', L"ト"},
-    {L'ド', L"ド"},
-    {L'ナ', L"ナ"},
-    {L'ニ', L"ニ"},
-    {L'ヌ', L"ヌ"},
-    {L'ネ', L"ネ"},
-    {L'ノ', L"ノ"},
-    {L'ハ', L"ハ"},
-    {L'バ', L"バ"},
-    {L'パ', L"パ"},
-    {L'ヒ', L"ヒ"},
-    {L'ビ', L"ビ"},
-    {L'ピ', L"ピ"},
-    {L'フ', L"フ"},
-    {L'ブ', L"ブ"},
-    {L'プ', L"プ"},
-    {L'ヘ', L"ヘ"},
-    {L'ベ', L"ベ"},
-    {L'ペ', L"ペ"},
-    {L'ホ', L"ホ"},
-    {L'ボ', L"ボ"},
-    {L'ポ', L"ポ"},
-    {L'マ', L"マ"},
-    {L'ミ', L"ミ"},
-    {L'ム', L"ム"},
-    {L'メ', L"メ"},
-    {L'モ', L"モ"},
-    {L'ャ', L"ャ"},
-    {L'ヤ', L"ヤ"},
-    {L'ュ', L"ュ"},
-    {L'ユ', L"ユ"},
-    {L'ョ', L"ョ"},
-    {L'ヨ', L"ヨ"},
-    {L'ラ', L"ラ"},
-    {L'リ', L"リ"},
-    {L'ル', L"ル"},
-    {L'レ', L"レ"},
-    {L'ロ', L"ロ"},
-    {L'ヮ', L"ヮ"},
-    {L'ワ', L"ワ"},
-    {L'ヰ', L"イ"},
-    {L'ヱ', L"エ"},
-    {L'ヲ', L"ヲ"},
-    {L'ン', L"ン"},
-    {L'ヴ', L"ヴ"},
-    {L'ヵ', L"ヵ"},
-    {L'ヶ', L"ヶ"},
-    {L'ヿ', L"コト"},
+namespace {
+
+using token_type = PronunciationPreprocessor::token_type;
+
+// hiragana and katakana blocks
+constexpr token_type KANA_FIRST = 0x3040;
+constexpr token_type KANA_SIZE = 0xC0;
+
+// marks letters that are expanded to multiple katakanas
+constexpr token_type EXPANDED = 1;
+
+// katakana of each kana, where old katakanas are replaced with current ones. 0 if not a kana
+constexpr token_type KANA_TABLE[KANA_SIZE] = {
+    0, L'ァ', L'ア', L'ィ', L'イ', L'ゥ', L'ウ', L'ェ', L'エ', L'ォ', L'オ', L'カ', L'ガ', L'キ', L'ギ', L'ク',
+    L'グ', L'ケ', L'ゲ', L'コ', L'ゴ', L'サ', L'ザ', L'シ', L'ジ', L'ス', L'ズ', L'セ', L'ゼ', L'ソ', L'ゾ', L'タ',
+    L'ダ', L'チ', L'ヂ', L'ッ', L'ツ', L'ヅ', L'テ', L'デ', L'ト', L'ド', L'ナ', L'ニ', L'ヌ', L'ネ', L'ノ', L'ハ',
+    L'バ', L'パ', L'ヒ', L'ビ', L'ピ', L'フ', L'ブ', L'プ', L'ヘ', L'ベ', L'ペ', L'ホ', L'ボ', L'ポ', L'マ', L'ミ',
+    L'ム', L'メ', L'モ', L'ャ', L'ヤ', L'ュ', L'ユ', L'ョ', L'ヨ', L'ラ', L'リ', L'ル', L'レ', L'ロ', L'ヮ', L'ワ',
+    L'イ', L'エ', L'ヲ', L'ン', L'ヴ', L'ヵ', L'ヶ', 0, 0, 0, 0, 0, 0, L'ヽ', L'ヾ', EXPANDED,
+    0, L'ァ', L'ア', L'ィ', L'イ', L'ゥ', L'ウ', L'ェ', L'エ', L'ォ', L'オ', L'カ', L'ガ', L'キ', L'ギ', L'ク',
+    L'グ', L'ケ', L'ゲ', L'コ', L'ゴ', L'サ', L'ザ', L'シ', L'ジ', L'ス', L'ズ', L'セ', L'ゼ', L'ソ', L'ゾ', L'タ',
+    L'ダ', L'チ', L'ヂ', L'ッ', L'ツ', L'ヅ', L'テ', L'デ', L'ト', L'ド', L'ナ', L'ニ', L'ヌ', L'ネ', L'ノ', L'ハ',
+    L'バ', L'パ', L'ヒ', L'ビ', L'ピ', L'フ', L'ブ', L'プ', L'ヘ', L'ベ', L'ペ', L'ホ', L'ボ', L'ポ', L'マ', L'ミ',
+    L'ム', L'メ', L'モ', L'ャ', L'ヤ', L'ュ', L'ユ', L'ョ', L'ヨ', L'ラ', L'リ', L'ル', L'レ', L'ロ', L'ヮ', L'ワ',
+    L'イ', L'エ', L'ヲ', L'ン', L'ヴ', L'ヵ', L'ヶ', 0, 0, 0, 0, 0, 0, 0, 0, EXPANDED,
 };
 
+constexpr struct
+{
+    token_type letter;
+    token_type katakanas[3];
+} KANA_EXPANSIONS[] = {
+    {L'ゟ', {L'ヨ', L'リ'}},
+    {L'ヿ', {L'コ', L'ト'}},
+};
+
+inline token_type to_katakana(token_type c)
+{
+    return KANA_FIRST <= c && c < KANA_FIRST + KANA_SIZE ? KANA_TABLE[c - KANA_FIRST] : 0;
+}
+
+// appends katakanas of c, or c itself if it is not a kana
+inline void append_katakana(string_type& s, token_type c)
+{
+    auto k = to_katakana(c);
+    if(k == 0){
+        s.push_back(c);
+    }
+    else if(k != EXPANDED){
+        s.push_back(k);
+    }
+    else{
+        for(const auto& e: KANA_EXPANSIONS){
+            if(e.letter == c){
+                s += e.katakanas;
+                break;
+            }
+        }
+    }
+}
+
+}
+
 bool PronunciationPreprocessor::isKanaWord(const string_type& w) const
 {
     for(const auto c: w){
-        if(KANA_MAP.find(c) == KANA_MAP.end()){
+        if(to_katakana(c) == 0){
             return false;
         }
     }
@@ -219,92 +107,69 @@ bool PronunciationPreprocessor::isKanaWord(const string_type& w) const
 string_type PronunciationPreprocessor::estimatePronunciation(const string_type& w) const
 {
     string_type y;
+    y.reserve(w.size());
     for(auto c: w){
-        if(KANA_MAP.find(c) == KANA_MAP.end()){
-            y.push_back(c);
-        }
-        else{
-            const auto& katakana = KANA_MAP.at(c);
-            for(auto d: katakana){
-                if(KANA_MAP.find(d) == KANA_MAP.end()){
-                    y.push_back(d);
-                }
-                else{
-                    y += KANA_MAP.at(d);
-                }
-            }
-        }
+        append_katakana(y, c);
     }
     return y;
 }
 
 PronunciationPreprocessor::PronunciationPreprocessor(
         const std::string& mecab_options, size_t mecab_feature_pos,
-        const std::string& mecab_pronunciation_of_marks):
-    tagger(MeCab::createTagger(validate_mecab_options(mecab_options).c_str())),
+        const std::string& mecab_pronunciation_of_marks, bool ascii_without_mecab):
+    tagger(std::make_shared<MeCabTagger>(mecab_options)),
     mecab_feature_pos(mecab_feature_pos),
-    mecab_pronunciation_of_marks(cast_string<string_type>(mecab_pronunciation_of_marks))
+    mecab_pronunciation_of_marks(cast_string<string_type>(mecab_pronunciation_of_marks)),
+    ascii_without_mecab(ascii_without_mecab),
+    counter(std::make_shared<Counter>())
 {}
 
 PronunciationPreprocessor::output_type PronunciationPreprocessor::operator()(
         const string_type& text, bool is_original) const
 {
-    std::string text_string = cast_string<std::string>(
-            is_original ? split(text, column_delimiter<string_type::value_type>())[0] : text);
-    output_type s;
-    {
-        std::lock_guard<std::mutex> lock(mutex_tagger);
-        for(const MeCab::Node* node = tagger->parseToNode(text_string.c_str()); node; node = node->next){
-            // skip BOS/EOS nodes
-            if(node->stat == MECAB_BOS_NODE || node->stat == MECAB_EOS_NODE){
-                continue;
-            }
+    const string_type input = is_original ? split(text, column_delimiter<string_type::value_type>())[0] : text;
 
-            // TODO: improve efficiency
-            // extract surface and features
-            string_type surface = cast_string<string_type>(std::string(node->surface, node->surface + node->length));
-            std::vector<string_type> feature;
-            const char *start = node->feature;
-            for(const char* end = start; *end != '\0'; ++end){
-                if(*end == ','){
-                    if(start < end){
-                        feature.push_back(cast_string<string_type>(std::string(start, end)));
-                    }
-                    start = end + 1;
-                }
-            }
-            if(*start != '\0'){
-                feature.push_back(cast_string<string_type>(std::string(start)));
-            }
-            while(feature.size() <= mecab_feature_pos){
-                feature.push_back(string_type());
-            }
+    output_type s;
+    // MeCab gives each kana word its katakanas, so that texts of only kanas need no analysis
+    if(isKanaWord(input)){
+        ++counter->kana;
+        s = estimatePronunciation(input);
+    }
+    else if(ascii_without_mecab && std::all_of(std::begin(input), std::end(input), [](token_type c){ return c < 0x80; })){
+        ++counter->ascii;
+        // whitespaces and control characters are ignored as MeCab does
+        std::copy_if(std::begin(input), std::end(input), std::back_inserter(s), [](token_type c){ return c > 0x20; });
+    }
+    else{
+        ++counter->mecab;
+        tagger->parse(cast_string<std::string>(input), [this, &s](const MeCabNode& node){
+            string_type surface = cast_string<string_type>(node.surface, node.surface + node.length);
+            // only the column of pronunciation is converted
+            auto feature = MeCabFeatureColumns<string_type>::column(node.feature, mecab_feature_pos);
 
-            // extract surface and features
             string_type pronunciation;
-            if(feature[mecab_feature_pos].empty() || feature[mecab_feature_pos] == L"*" || isKanaWord(surface)){
+            if(feature.empty() || (feature.size() == 1 && feature[0] == L'*') || isKanaWord(surface)){
                 pronunciation = estimatePronunciation(surface);
             }
-            else if(feature[mecab_feature_pos] == mecab_pronunciation_of_marks){
+            else if(feature == mecab_pronunciation_of_marks){
                 pronunciation = surface;
             }
             else{
                 // convert old katakanas
-                for(auto c: feature[mecab_feature_pos]){
-                    if(KANA_MAP.find(c) == KANA_MAP.end()){
-                        pronunciation.push_back(c);
-                    }
-                    else{
-                        pronunciation += KANA_MAP.at(c);
-                    }
+                for(auto c: feature){
+                    append_katakana(pronunciation, c);
                 }
             }
 
             for(auto c: pronunciation){
                 s.push_back(c);
             }
-        }
+        });
     }
+#ifdef DEBUG
+    std::cerr << "DEBUG: " << "pronunciation: kana=" << counter->kana << ", ascii=" << counter->ascii <<
+        ", mecab=" << counter->mecab << std::endl;
+#endif
     return s;
 }
 
@@ -22,12 +22,10 @@ limitations under the License.
 
 #include <memory>
 #include <string>
-#include <unordered_map>
-#include <mutex>
-
-#include <mecab.h>
+#include <atomic>
 
 #include "../string_util.hpp"
+#include "../mecab_util.hpp"
 
 namespace resembla {
 
@@ -37,21 +35,47 @@ struct PronunciationPreprocessor
     using token_type = string_type::value_type;
     using output_type = string_type;
 
+    // texts of only kanas are converted without MeCab. so are ASCII texts if ascii_without_mecab is true,
+    // whose pronunciations are texts themselves except whitespaces
     PronunciationPreprocessor(const std::string& mecab_options = "",
-            size_t mecab_feature_pos = 7, const std::string& mecab_pronunciation_of_marks = "");
+            size_t mecab_feature_pos = 7, const std::string& mecab_pronunciation_of_marks = "",
+            bool ascii_without_mecab = false);
     PronunciationPreprocessor(const PronunciationPreprocessor& obj) = default;
     virtual ~PronunciationPreprocessor() = default;
 
     output_type operator()(const string_type& text, bool is_original = false) const;
 
+    // numbers of texts converted without MeCab and with MeCab, which are shared among copies
+    size_t kana_count() const
+    {
+        return counter->kana;
+    }
+
+    size_t ascii_count() const
+    {
+        return counter->ascii;
+    }
+
+    size_t mecab_count() const
+    {
+        return counter->mecab;
+    }
+
 protected:
-    static const std::unordered_map<token_type, string_type> KANA_MAP;
+    struct Counter
+    {
+        std::atomic<size_t> kana{0};
+        std::atomic<size_t> ascii{0};
+        std::atomic<size_t> mecab{0};
+    };
 
-    std::shared_ptr<MeCab::Tagger> tagger;
-    mutable std::mutex mutex_tagger;
+    std::shared_ptr<MeCabTagger> tagger;
 
     const size_t mecab_feature_pos;
     string_type mecab_pronunciation_of_marks;
+    const bool ascii_without_mecab;
+
+    std::shared_ptr<Counter> counter;
 
     bool isKanaWord(const string_type& w) const;
     string_type estimatePronunciation(const string_type& w) const;
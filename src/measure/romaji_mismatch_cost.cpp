@@ -41,9 +41,16 @@ RomajiMismatchCost::RomajiMismatchCost(const std::string& letter_similarity_file
             }
         }
     }
+
+    costs.resize(TABLE_SIZE * TABLE_SIZE);
+    for(size_t a = 0; a < TABLE_SIZE; ++a){
+        for(size_t b = 0; b < TABLE_SIZE; ++b){
+            costs[a * TABLE_SIZE + b] = compute(static_cast<value_type>(a), static_cast<value_type>(b));
+        }
+    }
 }
 
-double RomajiMismatchCost::operator()(const value_type a, const value_type b) const
+double RomajiMismatchCost::compute(const value_type a, const value_type b) const
 {
     if(a == b){
         return 0L;
@@ -76,6 +83,15 @@ double RomajiMismatchCost::operator()(const value_type a, const value_type b) co
     return result;
 }
 
+double RomajiMismatchCost::min_mismatch_cost() const
+{
+    double result = std::min(1.0, case_mismatch_cost);
+    for(const auto& p: letter_similarities){
+        result = std::min(result, p.second);
+    }
+    return result;
+}
+
 RomajiMismatchCost::value_type RomajiMismatchCost::toLower(value_type a) const
 {
     if(L'A' <= a && a <= L'Z'){
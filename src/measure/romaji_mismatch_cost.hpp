@@ -21,6 +21,7 @@ limitations under the License.
 #define RESEMBLA_ROMAJI_MISMATCH_COST_HPP
 
 #include <string>
+#include <vector>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -34,11 +35,26 @@ struct RomajiMismatchCost
 
     RomajiMismatchCost(const std::string& letter_similarity_file_path, double case_mismatch_cost = 1L);
 
-    double operator()(const value_type reference, const value_type target) const;
+    double operator()(const value_type a, const value_type b) const
+    {
+        if(static_cast<size_t>(a) < TABLE_SIZE && static_cast<size_t>(b) < TABLE_SIZE){
+            return costs[a * TABLE_SIZE + b];
+        }
+        return compute(a, b);
+    }
+
+    // lower bound of costs between different letters
+    double min_mismatch_cost() const;
 
 protected:
+    // costs between ASCII letters are precomputed
+    static const size_t TABLE_SIZE = 128;
+
     std::unordered_map<string_type, double> letter_similarities;
     const double case_mismatch_cost;
+    std::vector<double> costs;
+
+    double compute(const value_type a, const value_type b) const;
 
     value_type toLower(value_type a) const;
 };
@@ -19,216 +19,256 @@ limitations under the License.
 
 #include "romaji_preprocessor.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace resembla {
 
-const std::unordered_map<string_type, string_type> RomajiPreprocessor::ROMAJI_MAP = {
-    {L"ァ", L"a"},
-    {L"ア", L"A"},
-    {L"ィ", L"i"},
-    {L"イ", L"I"},
-    {L"ゥ", L"u"},
-    {L"ウ", L"U"},
-    {L"ェ", L"e"},
-    {L"エ", L"E"},
-    {L"ォ", L"o"},
-    {L"オ", L"O"},
-    {L"カ", L"KA"},
-    {L"ガ", L"GA"},
-    {L"キ", L"KI"},
-    {L"ギ", L"GI"},
-    {L"ク", L"KU"},
-    {L"グ", L"GU"},
-    {L"ケ", L"KE"},
-    {L"ゲ", L"GE"},
-    {L"コ", L"KO"},
-    {L"ゴ", L"GO"},
-    {L"サ", L"SA"},
-    {L"ザ", L"ZA"},
-    {L"シ", L"SI"},
-    {L"ジ", L"ZI"},
-    {L"ス", L"SU"},
-    {L"ズ", L"ZU"},
-    {L"セ", L"SE"},
-    {L"ゼ", L"ZE"},
-    {L"ソ", L"SO"},
-    {L"ゾ", L"ZO"},
-    {L"タ", L"TA"},
-    {L"ダ", L"DA"},
-    {L"チ", L"TI"},
-    {L"ヂ", L"DI"},
-    {L"ッ", L"tu"},
-    {L"ツ", L"TU"},
-    {L"ヅ", L"DU"},
-    {L"テ", L"TE"},
-    {L"デ", L"DE"},
-    {L"ト", L"TO"},
-    {L"ド", L"DO"},
-    {L"ナ", L"NA"},
-    {L"ニ", L"NI"},
-    {L"ヌ", L"NU"},
-    {L"ネ", L"NE"},
-    {L"ノ", L"NO"},
-    {L"ハ", L"HA"},
-    {L"バ", L"BA"},
-    {L"パ", L"PA"},
-    {L"ヒ", L"HI"},
-    {L"ビ", L"BI"},
-    {L"ピ", L"PI"},
-    {L"フ", L"HU"},
-    {L"ブ", L"BU"},
-    {L"プ", L"PU"},
-    {L"ヘ", L"HE"},
-    {L"ベ", L"BE"},
-    {L"ペ", L"PE"},
-    {L"ホ", L"HO"},
-    {L"ボ", L"BO"},
-    {L"ポ", L"PO"},
-    {L"マ", L"MA"},
-    {L"ミ", L"MI"},
-    {L"ム", L"MU"},
-    {L"メ", L"ME"},
-    {L"モ", L"MO"},
-    {L"ャ", L"ya"},
-    {L"ヤ", L"YA"},
-    {L"ュ", L"yu"},
-    {L"ユ", L"YU"},
-    {L"ョ", L"yo"},
-    {L"ヨ", L"YO"},
-    {L"ラ", L"RA"},
-    {L"リ", L"RI"},
-    {L"ル", L"RU"},
-    {L"レ", L"RE"},
-    {L"ロ", L"RO"},
-    {L"ヮ", L"wa"},
-    {L"ワ", L"WA"},
-    {L"ヲ", L"WO"},
-    {L"ン", L"n"},
-    {L"ヴァ", L"VA"},
-    {L"ヴィ", L"VI"},
-    {L"ヴ", L"VU"},
-    {L"ヴェ", L"VE"},
-    {L"ヴォ", L"VO"},
-    {L"ヵ", L"ka"},
-    {L"ヶ", L"ke"},
-    {L"ー", L"-"},
-    {L"キャ", L"Kya"},
-    {L"ギャ", L"Gya"},
-    {L"キュ", L"Kyu"},
-    {L"ギュ", L"Gyu"},
-    {L"キョ", L"Kyo"},
-    {L"ギョ", L"Gyo"},
-    {L"シャ", L"Sya"},
-    {L"ジャ", L"Zya"},
-    {L"シュ", L"Syu"},
-    {L"ジュ", L"Zyu"},
-    {L"ショ", L"Syo"},
-    {L"ジョ", L"Zyo"},
-    {L"チャ", L"Tya"},
-    {L"ヂャ", L"Dya"},
-    {L"チュ", L"Tyu"},
-    {L"ヂュ", L"Dyu"},
-    {L"チョ", L"Tyo"},
-    {L"ヂョ", L"Dyo"},
-    {L"ニャ", L"Nya"},
-    {L"ニュ", L"Nyu"},
-    {L"ニョ", L"Nyo"},
-    {L"ヒャ", L"Hya"},
-    {L"ビャ", L"Bya"},
-    {L"ピャ", L"Pya"},
-    {L"ヒュ", L"Hyu"},
-    {L"ビュ", L"Byu"},
-    {L"ピュ", L"Pyu"},
-    {L"ヒョ", L"Hyo"},
-    {L"ビョ", L"Byo"},
-    {L"ピョ", L"Pyo"},
-    {L"ミャ", L"Mya"},
-    {L"ミュ", L"Myu"},
-    {L"ミョ", L"Myo"},
-    {L"リャ", L"Rya"},
-    {L"リュ", L"Ryu"},
-    {L"リョ", L"Ryo"},
-    {L"クヮ", L"Kwa"},
-    {L"グヮ", L"Gwa"},
-    {L"ウィ", L"ui"},
-    {L"ウェ", L"ue"},
-    {L"ウォ", L"uo"},
-    {L"チェ", L"Tie"},
-    {L"ティ", L"Tei"},
-    {L"ファ", L"Hua"},
-    {L"フィ", L"Hui"},
-    {L"フェ", L"Hue"},
-    {L"フォ", L"Huo"},
-    {L"ッカ", L"kKA"},
-    {L"ッガ", L"gGA"},
-    {L"ッキ", L"kKI"},
-    {L"ッギ", L"gGI"},
-    {L"ック", L"kKU"},
-    {L"ッグ", L"gGU"},
-    {L"ッケ", L"kKE"},
-    {L"ッゲ", L"gGE"},
-    {L"ッコ", L"kKO"},
-    {L"ッゴ", L"gGO"},
-    {L"ッサ", L"sSA"},
-    {L"ッザ", L"zZA"},
-    {L"ッシ", L"sSI"},
-    {L"ッジ", L"zZI"},
-    {L"ッス", L"sSU"},
-    {L"ッズ", L"zZU"},
-    {L"ッセ", L"sSE"},
-    {L"ッゼ", L"zZE"},
-    {L"ッソ", L"sSO"},
-    {L"ッゾ", L"zZO"},
-    {L"ッタ", L"tTA"},
-    {L"ッダ", L"dDA"},
-    {L"ッチ", L"tTI"},
-    {L"ッヂ", L"dDI"},
-    {L"ッツ", L"tTU"},
-    {L"ッヅ", L"dDU"},
-    {L"ッテ", L"tTE"},
-    {L"ッデ", L"dDE"},
-    {L"ット", L"tTO"},
-    {L"ッド", L"dDO"},
-    {L"ッナ", L"nNA"},
-    {L"ッニ", L"nNI"},
-    {L"ッヌ", L"nNU"},
-    {L"ッネ", L"nNE"},
-    {L"ッノ", L"nNO"},
-    {L"ッハ", L"hHA"},
-    {L"ッバ", L"bBA"},
-    {L"ッパ", L"pPA"},
-    {L"ッヒ", L"hHI"},
-    {L"ッビ", L"bBI"},
-    {L"ッピ", L"pPI"},
-    {L"ッフ", L"hHU"},
-    {L"ッブ", L"bBU"},
-    {L"ップ", L"pPU"},
-    {L"ッヘ", L"hHE"},
-    {L"ッベ", L"bBE"},
-    {L"ッペ", L"pPE"},
-    {L"ッホ", L"hHO"},
-    {L"ッボ", L"bBO"},
-    {L"ッポ", L"pPO"},
-    {L"ッマ", L"mMA"},
-    {L"ッミ", L"mMI"},
-    {L"ッム", L"mMU"},
-    {L"ッメ", L"mME"},
-    {L"ッモ", L"mMO"},
-    {L"ッヤ", L"yYA"},
-    {L"ッユ", L"yYU"},
-    {L"ッヨ", L"yYO"},
-    {L"ッラ", L"rRA"},
-    {L"ッリ", L"rRI"},
-    {L"ッル", L"rRU"},
-    {L"ッレ", L"rRE"},
-    {L"ッロ", L"rRO"},
-    {L"ッワ", L"wWA"},
-    {L"ッヲ", L"wWO"},
-    {L"ッヴ", L"vVU"},
+const std::unordered_map<std::string, std::string> RomajiPreprocessor::ROMAJI_MAP = {
+    {"ァ", "a"},
+    {"ア", "A"},
+    {"ィ", "i"},
+    {"イ", "I"},
+    {"ゥ", "u"},
+    {"ウ", "U"},
+    {"ェ", "e"},
+    {"エ", "E"},
+    {"ォ", "o"},
+    {"オ", "O"},
+    {"カ", "KA"},
+    {"ガ", "GA"},
+    {"キ", "KI"},
+    {"ギ", "GI"},
+    {"ク", "KU"},
+    {"グ", "GU"},
+    {"ケ", "KE"},
+    {"ゲ", "GE"},
+    {"コ", "KO"},
+    {"ゴ", "GO"},
+    {"サ", "SA"},
+    {"ザ", "ZA"},
+    {"シ", "SI"},
+    {"ジ", "ZI"},
+    {"ス", "SU"},
+    {"ズ", "ZU"},
+    {"セ", "SE"},
+    {"ゼ", "ZE"},
+    {"ソ", "SO"},
+    {"ゾ", "ZO"},
+    {"タ", "TA"},
+    {"ダ", "DA"},
+    {"チ", "TI"},
+    {"ヂ", "DI"},
+    {"ッ", "tu"},
+    {"ツ", "TU"},
+    {"ヅ", "DU"},
+    {"テ", "TE"},
+    {"デ", "DE"},
+    {"ト", "TO"},
+    {"ド", "DO"},
+    {"ナ", "NA"},
+    {"ニ", "NI"},
+    {"ヌ", "NU"},
+    {"ネ", "NE"},
+    {"ノ", "NO"},
+    {"ハ", "HA"},
+    {"バ", "BA"},
+    {"パ", "PA"},
+    {"ヒ", "HI"},
+    {"ビ", "BI"},
+    {"ピ", "PI"},
+    {"フ", "HU"},
+    {"ブ", "BU"},
+    {"プ", "PU"},
+    {"ヘ", "HE"},
+    {"ベ", "BE"},
+    {"ペ", "PE"},
+    {"ホ", "HO"},
+    {"ボ", "BO"},
+    {"ポ", "PO"},
+    {"マ", "MA"},
+    {"ミ", "MI"},
+    {"ム", "MU"},
+    {"メ", "ME"},
+    {"モ", "MO"},
+    {"ャ", "ya"},
+    {"ヤ", "YA"},
+    {"ュ", "yu"},
+    {"ユ", "YU"},
+    {"ョ", "yo"},
+    {"ヨ", "YO"},
+    {"ラ", "RA"},
+    {"リ", "RI"},
+    {"ル", "RU"},
+    {"レ", "RE"},
+    {"ロ", "RO"},
+    {"ヮ", "wa"},
+    {"ワ", "WA"},
+    {"ヲ", "WO"},
+    {"ン", "n"},
+    {"ヴァ", "VA"},
+    {"ヴィ", "VI"},
+    {"ヴ", "VU"},
+    {"ヴェ", "VE"},
+    {"ヴォ", "VO"},
+    {"ヵ", "ka"},
+    {"ヶ", "ke"},
+    {"ー", "-"},
+    {"キャ", "Kya"},
+    {"ギャ", "Gya"},
+    {"キュ", "Kyu"},
+    {"ギュ", "Gyu"},
+    {"キョ", "Kyo"},
+    {"ギョ", "Gyo"},
+    {"シャ", "Sya"},
+    {"ジャ", "Zya"},
+    {"シュ", "Syu"},
+    {"ジュ", "Zyu"},
+    {"ショ", "Syo"},
+    {"ジョ", "Zyo"},
+    {"チャ", "Tya"},
+    {"ヂャ", "Dya"},
+    {"チュ", "Tyu"},
+    {"ヂュ", "Dyu"},
+    {"チョ", "Tyo"},
+    {"ヂョ", "Dyo"},
+    {"ニャ", "Nya"},
+    {"ニュ", "Nyu"},
+    {"ニョ", "Nyo"},
+    {"ヒャ", "Hya"},
+    {"ビャ", "Bya"},
+    {"ピャ", "Pya"},
+    {"ヒュ", "Hyu"},
+    {"ビュ", "Byu"},
+    {"ピュ", "Pyu"},
+    {"ヒョ", "Hyo"},
+    {"ビョ", "Byo"},
+    {"ピョ", "Pyo"},
+    {"ミャ", "Mya"},
+    {"ミュ", "Myu"},
+    {"ミョ", "Myo"},
+    {"リャ", "Rya"},
+    {"リュ", "Ryu"},
+    {"リョ", "Ryo"},
+    {"クヮ", "Kwa"},
+    {"グヮ", "Gwa"},
+    {"ウィ", "ui"},
+    {"ウェ", "ue"},
+    {"ウォ", "uo"},
+    {"チェ", "Tie"},
+    {"ティ", "Tei"},
+    {"ファ", "Hua"},
+    {"フィ", "Hui"},
+    {"フェ", "Hue"},
+    {"フォ", "Huo"},
+    {"ッカ", "kKA"},
+    {"ッガ", "gGA"},
+    {"ッキ", "kKI"},
+    {"ッギ", "gGI"},
+    {"ック", "kKU"},
+    {"ッグ", "gGU"},
+    {"ッケ", "kKE"},
+    {"ッゲ", "gGE"},
+    {"ッコ", "kKO"},
+    {"ッゴ", "gGO"},
+    {"ッサ", "sSA"},
+    {"ッザ", "zZA"},
+    {"ッシ", "sSI"},
+    {"ッジ", "zZI"},
+    {"ッス", "sSU"},
+    {"ッズ", "zZU"},
+    {"ッセ", "sSE"},
+    {"ッゼ", "zZE"},
+    {"ッソ", "sSO"},
+    {"ッゾ", "zZO"},
+    {"ッタ", "tTA"},
+    {"ッダ", "dDA"},
+    {"ッチ", "tTI"},
+    {"ッヂ", "dDI"},
+    {"ッツ", "tTU"},
+    {"ッヅ", "dDU"},
+    {"ッテ", "tTE"},
+    {"ッデ", "dDE"},
+    {"ット", "tTO"},
+    {"ッド", "dDO"},
+    {"ッナ", "nNA"},
+    {"ッニ", "nNI"},
+    {"ッヌ", "nNU"},
+    {"ッネ", "nNE"},
+    {"ッノ", "nNO"},
+    {"ッハ", "hHA"},
+    {"ッバ", "bBA"},
+    {"ッパ", "pPA"},
+    {"ッヒ", "hHI"},
+    {"ッビ", "bBI"},
+    {"ッピ", "pPI"},
+    {"ッフ", "hHU"},
+    {"ッブ", "bBU"},
+    {"ップ", "pPU"},
+    {"ッヘ", "hHE"},
+    {"ッベ", "bBE"},
+    {"ッペ", "pPE"},
+    {"ッホ", "hHO"},
+    {"ッボ", "bBO"},
+    {"ッポ", "pPO"},
+    {"ッマ", "mMA"},
+    {"ッミ", "mMI"},
+    {"ッム", "mMU"},
+    {"ッメ", "mME"},
+    {"ッモ", "mMO"},
+    {"ッヤ", "yYA"},
+    {"ッユ", "yYU"},
+    {"ッヨ", "yYO"},
+    {"ッラ", "rRA"},
+    {"ッリ", "rRI"},
+    {"ッル", "rRU"},
+    {"ッレ", "rRE"},
+    {"ッロ", "rRO"},
+    {"ッワ", "wWA"},
+    {"ッヲ", "wWO"},
+    {"ッヴ", "vVU"},
 };
 
+const size_t RomajiPreprocessor::Romaji::MAX_LENGTH;
+const RomajiPreprocessor::token_type RomajiPreprocessor::RomajiTable::FIRST;
+const size_t RomajiPreprocessor::RomajiTable::SIZE;
+const size_t RomajiPreprocessor::RomajiTable::NO_PAIR;
+
+const RomajiPreprocessor::RomajiTable RomajiPreprocessor::ROMAJI_TABLE(RomajiPreprocessor::ROMAJI_MAP);
+
+RomajiPreprocessor::RomajiTable::RomajiTable(const std::unordered_map<std::string, std::string>& romaji_map):
+    singles(SIZE, Romaji{{}, 0}), pair_rows(SIZE, NO_PAIR)
+{
+    auto in_block = [](token_type c){
+        return FIRST <= c && static_cast<size_t>(c) < FIRST + SIZE;
+    };
+    for(const auto& p: romaji_map){
+        auto katakanas = cast_string<string_type>(p.first);
+        if(katakanas.empty() || katakanas.size() > 2 || p.second.size() > Romaji::MAX_LENGTH ||
+                !std::all_of(std::begin(katakanas), std::end(katakanas), in_block)){
+            throw std::logic_error("romaji map has an entry out of table");
+        }
+
+        Romaji* romaji;
+        if(katakanas.size() == 1){
+            romaji = &singles[katakanas[0] - FIRST];
+        }
+        else{
+            auto& row = pair_rows[katakanas[0] - FIRST];
+            if(row == NO_PAIR){
+                row = pairs.size() / SIZE;
+                pairs.resize(pairs.size() + SIZE, Romaji{{}, 0});
+            }
+            romaji = &pairs[row * SIZE + katakanas[1] - FIRST];
+        }
+        std::copy(std::begin(p.second), std::end(p.second), romaji->letters);
+        romaji->length = p.second.size();
+    }
+}
+
 RomajiPreprocessor::RomajiPreprocessor(const std::string& mecab_options, size_t mecab_feature_pos,
-        const std::string& mecab_pronunciation_of_marks, bool keep_case):
-    PronunciationPreprocessor(mecab_options, mecab_feature_pos, mecab_pronunciation_of_marks),
+        const std::string& mecab_pronunciation_of_marks, bool keep_case, bool ascii_without_mecab):
+    PronunciationPreprocessor(mecab_options, mecab_feature_pos, mecab_pronunciation_of_marks, ascii_without_mecab),
     keep_case(keep_case)
 {}
 
@@ -236,31 +276,34 @@ RomajiPreprocessor::output_type RomajiPreprocessor::operator()(const string_type
 {
     output_type s;
     auto pronunciation = PronunciationPreprocessor::operator()(text);
+    s.reserve(pronunciation.size() * 2);
     for(size_t i = 0; i < pronunciation.size(); ++i){
-        string_type p = {pronunciation[i]};
+        const token_type* letters = &pronunciation[i];
+        size_t length = 1;
         // try to read-ahead next letter
-        if(i + 1 < pronunciation.size()){
-            auto q = p + pronunciation[i + 1];
+        const Romaji* romaji = i + 1 < pronunciation.size() ?
+            ROMAJI_TABLE.find(pronunciation[i], pronunciation[i + 1]) : nullptr;
+        if(romaji != nullptr){
             // if concatenated string exists in map, they can be converted to romaji at once
-            if(ROMAJI_MAP.find(q) != ROMAJI_MAP.end()){
-                if(p == L"ッ"){
-                    // only process the first letter 'ッ' because pronunciation[i+1..i+2] may be able to concatenate
-                    p = {ROMAJI_MAP.at(q)[0]};
-                }
-                else{
-                    p = q;
-                    ++i;
-                }
+            letters = romaji->letters;
+            if(pronunciation[i] == L'ッ'){
+                // only process the first letter 'ッ' because pronunciation[i+1..i+2] may be able to concatenate
+                length = 1;
+            }
+            else{
+                length = romaji->length;
+                ++i;
             }
         }
-
-        // convert to romaji if p exists in map
-        if(ROMAJI_MAP.count(p) > 0){
-            p = ROMAJI_MAP.at(p);
+        // convert to romaji if the letter exists in map
+        else if((romaji = ROMAJI_TABLE.find(pronunciation[i])) != nullptr){
+            letters = romaji->letters;
+            length = romaji->length;
         }
 
         // put each roman alphabet to output sequence
-        for(auto c: p){
+        for(size_t j = 0; j < length; ++j){
+            auto c = letters[j];
             if(!keep_case && L'A' <= c && c <= L'Z'){
                 c = c - L'A' + L'a';
             }
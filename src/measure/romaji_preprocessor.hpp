@@ -20,6 +20,8 @@ limitations under the License.
 #ifndef RESEMBLA_ROMAJI_PREPROCESSOR_HPP
 #define RESEMBLA_ROMAJI_PREPROCESSOR_HPP
 
+#include <vector>
+
 #include "pronunciation_preprocessor.hpp"
 
 namespace resembla {
@@ -27,13 +29,65 @@ namespace resembla {
 struct RomajiPreprocessor: public PronunciationPreprocessor
 {
     RomajiPreprocessor(const std::string& mecab_options = "", size_t mecab_feature_pos = 7,
-            const std::string& mecab_pronunciation_of_marks = "", bool keep_case = false);
+            const std::string& mecab_pronunciation_of_marks = "", bool keep_case = false,
+            bool ascii_without_mecab = false);
     virtual ~RomajiPreprocessor() = default;
 
     output_type operator()(const string_type& text, bool is_original = false) const;
 
 protected:
-    static const std::unordered_map<string_type, string_type> ROMAJI_MAP;
+    // katakanas and romaji in UTF-8, which are converted into ROMAJI_TABLE
+    static const std::unordered_map<std::string, std::string> ROMAJI_MAP;
+
+    struct Romaji
+    {
+        static const size_t MAX_LENGTH = 3;
+
+        token_type letters[MAX_LENGTH];
+        size_t length;
+    };
+
+    // dense tables of ROMAJI_MAP indexed by offsets of katakanas, which look up romaji without hashing
+    class RomajiTable
+    {
+    public:
+        RomajiTable(const std::unordered_map<std::string, std::string>& romaji_map);
+
+        // returns nullptr if the letter or pair is not in the map
+        const Romaji* find(token_type c) const
+        {
+            if(c < FIRST || FIRST + SIZE <= static_cast<size_t>(c) || singles[c - FIRST].length == 0){
+                return nullptr;
+            }
+            return &singles[c - FIRST];
+        }
+
+        const Romaji* find(token_type c, token_type d) const
+        {
+            if(c < FIRST || FIRST + SIZE <= static_cast<size_t>(c) ||
+                    d < FIRST || FIRST + SIZE <= static_cast<size_t>(d)){
+                return nullptr;
+            }
+            auto row = pair_rows[c - FIRST];
+            if(row == NO_PAIR || pairs[row * SIZE + d - FIRST].length == 0){
+                return nullptr;
+            }
+            return &pairs[row * SIZE + d - FIRST];
+        }
+
+    protected:
+        // katakana block
+        static const token_type FIRST = 0x30A0;
+        static const size_t SIZE = 0x60;
+        static const size_t NO_PAIR = static_cast<size_t>(-1);
+
+        std::vector<Romaji> singles;
+        // rows of pairs for letters that start any pairs
+        std::vector<size_t> pair_rows;
+        std::vector<Romaji> pairs;
+    };
+
+    static const RomajiTable ROMAJI_TABLE;
 
     bool keep_case;
 };
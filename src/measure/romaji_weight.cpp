@@ -86,9 +86,14 @@ RomajiWeight::RomajiWeight(double base_weight, double delete_insert_ratio,
     base_weight(base_weight), delete_insert_ratio(delete_insert_ratio),
     uppercase_coefficient(uppercase_coefficient), lowercase_coefficient(lowercase_coefficient),
     vowel_coefficient(vowel_coefficient), consonant_coefficient(consonant_coefficient)
-{}
+{
+    for(size_t c = 0; c < TABLE_SIZE; ++c){
+        weights[0][c] = compute(static_cast<value_type>(c), false);
+        weights[1][c] = compute(static_cast<value_type>(c), true);
+    }
+}
 
-double RomajiWeight::operator()(const value_type c, bool is_original, size_t, size_t) const
+double RomajiWeight::compute(const value_type c, bool is_original) const
 {
     double weight = base_weight;
     if(is_original){
@@ -21,6 +21,7 @@ limitations under the License.
 #define RESEMBLA_ROMAJI_WEIGHT_HPP
 
 #include <cstddef>
+#include <vector>
 #include <unordered_set>
 
 namespace resembla {
@@ -33,9 +34,31 @@ struct RomajiWeight
             double uppercase_coefficient = 1L, double lowercase_coefficient = 1L,
             double vowel_coefficient = 1L, double consonant_coefficient = 1L);
 
-    double operator()(const value_type c, bool is_original = false, size_t total = -1, size_t position = -1) const;
+    double operator()(const value_type c, bool is_original = false, size_t total = -1, size_t position = -1) const
+    {
+        (void)total;
+        (void)position;
+
+        if(static_cast<size_t>(c) < TABLE_SIZE){
+            return weights[is_original][c];
+        }
+        return is_original ? base_weight * delete_insert_ratio : base_weight;
+    }
+
+    // weights all letters of s at once and passes them to put in order
+    template<typename sequence_type, typename Put>
+    void weigh(const sequence_type& s, bool is_original, Put put) const
+    {
+        for(const auto& c: s){
+            put((*this)(c, is_original));
+        }
+    }
 
 protected:
+    // weights of ASCII letters are precomputed for insertion and deletion
+    static const size_t TABLE_SIZE = 128;
+    double weights[2][TABLE_SIZE];
+
     const double base_weight;
     const double delete_insert_ratio;
 
@@ -48,6 +71,8 @@ protected:
     static const std::unordered_set<value_type> VOWELS;
     static const std::unordered_set<value_type> CONSONANTS;
 
+    double compute(const value_type c, bool is_original) const;
+
     static bool isLower(value_type c);
     static bool isUpper(value_type c);
     static bool isVowel(value_type c);
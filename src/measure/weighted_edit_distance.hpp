@@ -21,9 +21,18 @@ limitations under the License.
 #define RESEMBLA_WEIGHTED_EDIT_DISTANCE_HPP
 
 #include <string>
+#include <cstdint>
+#include <cstring>
 #include <vector>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
 
 #include "fixed_cost.hpp"
+#include "fixed_point.hpp"
+#include "histogram_filter.hpp"
+#include "batch_edit_distance.hpp"
 
 namespace resembla {
 
@@ -34,8 +43,23 @@ struct WeightedEditDistance
 
     WeightedEditDistance(CostFunction cost = CostFunction()): cost(cost) {}
 
+    // define RESEMBLA_SIMD to use the anti-diagonal kernel, which is vectorized by compilers.
+    // it pays off only if anti-diagonals are long enough to fill vectors, so short sequences
+    // and sequences with quantized weights are always computed column by column
     template<typename sequence_type>
     double operator()(const sequence_type& a, const sequence_type& b) const
+    {
+#ifdef RESEMBLA_SIMD
+        if(use_diagonal(a, b)){
+            return diagonal(a, b);
+        }
+#endif
+        return columnwise(a, b);
+    }
+
+    // standard column-by-column dynamic programming
+    template<typename sequence_type>
+    double columnwise(const sequence_type& a, const sequence_type& b) const
     {
         if(a.empty()){
             return b.empty() ? 1.0 : 0.0;
@@ -44,30 +68,318 @@ struct WeightedEditDistance
             return 0.0;
         }
 
+        using FP = FixedPoint<weight_type<sequence_type>>;
+
         // prepare work table
-        std::vector<double> D(a.size() + 1);
+        std::vector<typename FP::cell_type> D(a.size() + 1);
         D[0] = 0;
         for(size_t i = 1; i < a.size() + 1; ++i){
-            D[i] = D[i - 1] + a[i - 1].weight;
+            D[i] = D[i - 1] + FP::indel(a[i - 1].weight);
         }
 
         // compute edit distance
         auto max_cost = D.back();
         for(const auto& c: b){
             auto prev = D[0];
-            D[0] += c.weight;
+            D[0] += FP::indel(c.weight);
             for(size_t i = 1; i < a.size() + 1; ++i){
-                auto del = D[i - 1] + a[i - 1].weight;
-                auto ins = D[i] + c.weight;
-                auto sub = prev + (a[i - 1].weight + c.weight) * cost(a[i - 1].token, c.token);
+                auto del = D[i - 1] + FP::indel(a[i - 1].weight);
+                auto ins = D[i] + FP::indel(c.weight);
+                auto sub = prev + FP::substitution(a[i - 1].weight, c.weight, cost(a[i - 1].token, c.token));
                 prev = D[i];
                 D[i] = std::min({del, ins, sub});
             }
         }
         max_cost += D.front();
     
-        return 1.0 - D.back() / max_cost;
+        return 1.0 - static_cast<double>(D.back()) / max_cost;
     }
+
+    // computes the same table in single precision along anti-diagonals.
+    // cells on an anti-diagonal don't depend on each other, so the inner loop
+    // is a plain min/add over contiguous float arrays and can be vectorized.
+    // with min_score, cells are limited to the band and computation stops early as in the bounded overload
+    template<typename sequence_type>
+    double diagonal(const sequence_type& a, const sequence_type& b, double min_score = 0.0) const
+    {
+        if(a.empty()){
+            return b.empty() ? 1.0 : 0.0;
+        }
+        else if(b.empty()){
+            return 0.0;
+        }
+
+        const size_t n = a.size(), m = b.size();
+        const auto bound = make_bound<FixedPoint<double>>(a, b, min_score);
+        if(bound.length_diff > bound.band){
+            return 1.0 - bound.length_diff * bound.min_weight / bound.max_cost;
+        }
+        const size_t band = bound.band;
+
+        // weights of a, and reversed weights of b to access them in the same direction as a
+        std::vector<float> wa(n), wb_reversed(m);
+        for(size_t i = 0; i < n; ++i){
+            wa[i] = static_cast<float>(a[i].weight);
+        }
+        for(size_t j = 0; j < m; ++j){
+            wb_reversed[m - 1 - j] = static_cast<float>(b[j].weight);
+        }
+
+        // substitution costs in the band are computed column by column ahead of the anti-diagonals using them,
+        // so that the kernel reads them from contiguous memory. cell (i, j) is at (i + j) * width + i - band_begin(i + j)
+        const size_t width = std::min(n, band) + 1;
+        auto band_begin = [band](size_t d){ return d > band ? (d - band + 1) / 2 : 0; };
+        std::vector<float> sub((n + m + 1) * width);
+
+        // three anti-diagonals indexed by the position in a. cells next to the band are infinity
+        const float infinity = std::numeric_limits<float>::infinity();
+        const float max_distance = static_cast<float>(bound.max_distance + DIAGONAL_TOLERANCE * bound.max_cost);
+        std::vector<float> buffer(3 * (n + 1), infinity);
+        float* D2 = &buffer[0];
+        float* D1 = D2 + n + 1;
+        float* D0 = D1 + n + 1;
+        float prefix_a = 0.0f, prefix_b = 0.0f;
+        size_t previous_lo = 0, previous_hi = 0;
+        for(size_t d = 0; d < n + m + 1; ++d){
+            // cells in column d are on anti-diagonals after d
+            if(d > 0 && d < m + 1){
+                const size_t j = d;
+                size_t first = j > band ? j - band : 1;
+                size_t last = std::min(n, j + band);
+                for(size_t i = first; i < last + 1; ++i){
+                    sub[(i + j) * width + i - band_begin(i + j)] = static_cast<float>(
+                        (a[i - 1].weight + b[j - 1].weight) * cost(a[i - 1].token, b[j - 1].token));
+                }
+            }
+
+            // cells (i, d - i) in the table and the band
+            size_t lo = std::max(d > m ? d - m : 0, band_begin(d));
+            size_t hi = std::min(std::min(n, d), (d + band) / 2);
+
+            // boundary cells
+            if(lo == 0){
+                D0[0] = prefix_b;
+            }
+            if(hi == d){
+                D0[d] = prefix_a;
+            }
+            if(d < m){
+                prefix_b += wb_reversed[m - 1 - d];
+            }
+            if(d < n){
+                prefix_a += wa[d];
+            }
+
+            // inner cells
+            size_t first = std::max<size_t>(lo, 1);
+            size_t last = d > 0 ? std::min(hi, d - 1) : 0;
+            if(first <= last){
+                const float* S = &sub[d * width - band_begin(d)];
+                for(size_t i = first; i < last + 1; ++i){
+                    float del = D1[i - 1] + wa[i - 1];
+                    float ins = D1[i] + wb_reversed[i + m - d];
+                    float rep = D2[i - 1] + S[i];
+                    D0[i] = std::min(std::min(del, ins), rep);
+                }
+            }
+            if(lo > 0){
+                D0[lo - 1] = infinity;
+            }
+            if(hi < n){
+                D0[hi + 1] = infinity;
+            }
+
+            // every alignment passes through this anti-diagonal or the previous one.
+            // cells are not negative, so bit patterns of them are in the same order and their minimum is vectorized
+            if(max_distance < infinity && d % ABANDON_INTERVAL == 0 && d > 0){
+                uint32_t current_min = min_bits(D0 + lo, D0 + hi + 1);
+                current_min = std::min(current_min, min_bits(D1 + previous_lo, D1 + previous_hi + 1));
+                if(current_min > to_bits(max_distance)){
+                    return 1.0 - bound.max_distance / bound.max_cost;
+                }
+            }
+            previous_lo = lo;
+            previous_hi = hi;
+
+            std::swap(D2, D1);
+            std::swap(D1, D0);
+        }
+
+        if(D1[n] > max_distance){
+            return 1.0 - bound.max_distance / bound.max_cost;
+        }
+        return 1.0 - D1[n] / bound.max_cost;
+    }
+
+    // same as above, but stops computation as soon as the score turns out to be less than min_score.
+    // returns the exact score if it is not less than min_score, and an upper bound of the score otherwise
+    template<typename sequence_type>
+    double operator()(const sequence_type& a, const sequence_type& b, double min_score) const
+    {
+        if(min_score <= 0.0 || a.empty() || b.empty()){
+            return (*this)(a, b);
+        }
+#ifdef RESEMBLA_SIMD
+        if(use_diagonal(a, b)){
+            return diagonal(a, b, min_score);
+        }
+#endif
+        return columnwise(a, b, min_score);
+    }
+
+    // column-by-column dynamic programming in the band
+    template<typename sequence_type>
+    double columnwise(const sequence_type& a, const sequence_type& b, double min_score) const
+    {
+        using FP = FixedPoint<weight_type<sequence_type>>;
+        using cell_type = typename FP::cell_type;
+
+        const auto bound = make_bound<FP>(a, b, min_score);
+        if(bound.length_diff > bound.band){
+            return 1.0 - bound.length_diff * bound.min_weight / bound.max_cost;
+        }
+        const size_t band = bound.band;
+        const double max_distance = bound.max_distance, max_cost = bound.max_cost;
+
+        // prepare work table. cells outside the band are treated as infinity
+        std::vector<cell_type> D(a.size() + 1, FP::infinity());
+        D[0] = 0;
+        for(size_t i = 1; i < std::min(a.size(), band) + 1; ++i){
+            D[i] = D[i - 1] + FP::indel(a[i - 1].weight);
+        }
+
+        // compute edit distance in the band
+        for(size_t j = 1; j < b.size() + 1; ++j){
+            const auto& c = b[j - 1];
+            size_t first = j > band ? j - band : 1;
+            size_t last = std::min(a.size(), j + band);
+
+            auto prev = D[first - 1];
+            cell_type column_min;
+            if(first == 1){
+                D[0] += FP::indel(c.weight);
+                column_min = D[0];
+            }
+            else{
+                D[first - 1] = FP::infinity();
+                column_min = D[first - 1];
+            }
+            for(size_t i = first; i < last + 1; ++i){
+                auto del = D[i - 1] + FP::indel(a[i - 1].weight);
+                auto ins = D[i] + FP::indel(c.weight);
+                auto sub = prev + FP::substitution(a[i - 1].weight, c.weight, cost(a[i - 1].token, c.token));
+                prev = D[i];
+                D[i] = std::min({del, ins, sub});
+                column_min = std::min(column_min, D[i]);
+            }
+
+            // every alignment passes through this column, and alignments within
+            // max_distance are never affected by the band
+            if(column_min > max_distance){
+                return 1.0 - max_distance / max_cost;
+            }
+        }
+
+        return 1.0 - static_cast<double>(D.back()) / max_cost;
+    }
+
+    // cost functions knowing the minimum cost between different tokens allow to bound scores
+    // by token histograms, so the query is wrapped with its histogram
+    template<typename sequence_type, typename F = CostFunction>
+    typename std::enable_if<std::is_same<decltype(std::declval<const F&>().min_mismatch_cost()), double>::value,
+        HistogramFilter<WeightedEditDistance, sequence_type>>::type
+    prepare(const sequence_type& a) const
+    {
+        return HistogramFilter<WeightedEditDistance, sequence_type>(*this, a,
+                FixedPoint<weight_type<sequence_type>>::round_cost(cost.min_mismatch_cost()));
+    }
+
+    // scores groups of sequences against a in SIMD lanes. sequences with 16-bit weights are scored exactly,
+    // and those with floating point weights are scored in single precision with RESEMBLA_SIMD
+    template<typename sequence_type, typename Lane = typename BatchLane<typename std::decay<
+        decltype(std::declval<const sequence_type&>()[0].weight)>::type>::type,
+        typename = typename std::enable_if<has_token_order<WeightedTokenAccess, sequence_type>::value>::type>
+    BatchEditDistance<WeightedEditDistance, WeightedTokenAccess, sequence_type, Lane> batch(const sequence_type& a) const
+    {
+        return BatchEditDistance<WeightedEditDistance, WeightedTokenAccess, sequence_type, Lane>(*this, a);
+    }
+
+protected:
+    template<typename sequence_type>
+    using weight_type = typename std::decay<decltype(std::declval<const sequence_type&>()[0].weight)>::type;
+
+    // score >= min_score <=> distance <= (1 - min_score) * max_cost.
+    // reaching cell (i, j) needs at least |i - j| insertions or deletions,
+    // so only cells within the band can be on alignments cheaper than max_distance
+    struct Bound
+    {
+        double max_cost;
+        double max_distance;
+        double min_weight;
+        size_t band;
+        size_t length_diff;
+    };
+
+    template<typename FP, typename sequence_type>
+    static Bound make_bound(const sequence_type& a, const sequence_type& b, double min_score)
+    {
+        Bound bound = {0.0, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(),
+            std::max(a.size(), b.size()), a.size() > b.size() ? a.size() - b.size() : b.size() - a.size()};
+        for(const auto& t: a){
+            double w = static_cast<double>(FP::indel(t.weight));
+            bound.max_cost += w;
+            bound.min_weight = std::min(bound.min_weight, w);
+        }
+        for(const auto& t: b){
+            double w = static_cast<double>(FP::indel(t.weight));
+            bound.max_cost += w;
+            bound.min_weight = std::min(bound.min_weight, w);
+        }
+        if(min_score <= 0.0){
+            return bound;
+        }
+
+        bound.max_distance = (1.0 - min_score + BOUND_TOLERANCE) * bound.max_cost;
+        if(bound.min_weight > 0.0 && bound.max_distance / bound.min_weight < bound.band){
+            bound.band = static_cast<size_t>(bound.max_distance / bound.min_weight);
+        }
+        return bound;
+    }
+
+    // margin of scores to keep candidates whose score is equal to min_score in spite of rounding errors
+    static constexpr double BOUND_TOLERANCE = 1e-9;
+
+    template<typename sequence_type>
+    static bool use_diagonal(const sequence_type& a, const sequence_type& b)
+    {
+        return std::is_floating_point<weight_type<sequence_type>>::value &&
+            std::min(a.size(), b.size()) >= DIAGONAL_MIN_LENGTH;
+    }
+
+    static uint32_t to_bits(float x)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        return bits;
+    }
+
+    static uint32_t min_bits(const float* begin, const float* end)
+    {
+        uint32_t result = std::numeric_limits<uint32_t>::max();
+        for(auto p = begin; p < end; ++p){
+            result = std::min(result, to_bits(*p));
+        }
+        return result;
+    }
+
+    // margin of distances for rounding errors of single precision
+    static constexpr double DIAGONAL_TOLERANCE = 1e-5;
+
+    // shortest sequences computed along anti-diagonals. measured with AVX2
+    static const size_t DIAGONAL_MIN_LENGTH = 32;
+
+    // number of anti-diagonals between checks for early abandoning
+    static const size_t ABANDON_INTERVAL = 16;
 };
 
 }
@@ -22,20 +22,26 @@ limitations under the License.
 
 #include <vector>
 #include <memory>
+#include <utility>
 
 #include "../string_util.hpp"
+#include "fixed_point.hpp"
 
 namespace resembla {
 
-template<typename SequenceTokenizer, typename WeightFunction>
+template<typename T, typename W = double>
+struct WeightedToken
+{
+    T token;
+    W weight;
+};
+
+// weights are quantized to fixed-point numbers if weight_type is an integral type
+template<typename SequenceTokenizer, typename WeightFunction, typename weight_type = double>
 class WeightedSequenceBuilder
 {
 public:
-    struct token_type
-    {
-        typename SequenceTokenizer::token_type token;
-        double weight;
-    };
+    using token_type = WeightedToken<typename SequenceTokenizer::token_type, weight_type>;
     using output_type = std::vector<token_type>;
 
     WeightedSequenceBuilder(const std::shared_ptr<SequenceTokenizer> tokenize,
@@ -46,16 +52,46 @@ public:
     {
         auto s = (*tokenize)(is_original ?
                 split(text, column_delimiter<string_type::value_type>())[0] : text, is_original);
-        output_type ws;
-        for(size_t i = 0; i < s.size(); ++i){
-            ws.push_back({s[i], (*weight_func)(s[i], is_original, s.size(), i)});
+        return build(s, is_original, 0);
+    }
+
+    // lets tokenizers providing intern(token) share data among tokens of the corpus
+    template<typename T = SequenceTokenizer>
+    auto intern(output_type& ws) const -> decltype(std::declval<const T&>().intern(ws[0].token), void())
+    {
+        for(auto& w: ws){
+            w.token = tokenize->intern(w.token);
         }
-        return ws;
     }
 
 protected:
     std::shared_ptr<SequenceTokenizer> tokenize;
     std::shared_ptr<WeightFunction> weight_func;
+
+    // weight functions providing weigh(s, is_original, put) compute weights of whole sequences in one pass.
+    // weights are quantized and stored as they are computed
+    template<typename sequence_type, typename F = WeightFunction>
+    auto build(const sequence_type& s, bool is_original, int) const
+        -> decltype(std::declval<const F&>().weigh(s, is_original, std::declval<void(*)(double)>()), output_type())
+    {
+        output_type ws;
+        ws.reserve(s.size());
+        weight_func->weigh(s, is_original, [&s, &ws](double w){
+            ws.push_back({s[ws.size()], FixedPoint<weight_type>::quantize(w)});
+        });
+        return ws;
+    }
+
+    template<typename sequence_type>
+    output_type build(const sequence_type& s, bool is_original, long) const
+    {
+        output_type ws;
+        ws.reserve(s.size());
+        for(size_t i = 0; i < s.size(); ++i){
+            ws.push_back({s[i], FixedPoint<weight_type>::quantize((*weight_func)(s[i], is_original, s.size(), i))});
+        }
+        return ws;
+    }
 };
 
 }
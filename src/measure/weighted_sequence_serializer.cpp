@@ -19,53 +19,130 @@ limitations under the License.
 
 #include "weighted_sequence_serializer.hpp"
 
+#include <cstdint>
 #include <string>
 #include <vector>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 
 #include "../string_util.hpp"
+#include "fixed_point.hpp"
 
 namespace resembla {
 
-void to_json(nlohmann::json& j, const typename WeightedSequenceBuilder<WordPreprocessor<string_type>, WordWeight>::token_type& o)
+namespace {
+
+template<typename weight_type>
+nlohmann::json weight_format()
+{
+    int bits = std::is_integral<weight_type>::value ? sizeof(weight_type) * 8 : 0;
+    double scale = FixedPoint<weight_type>::WEIGHT_SCALE;
+    return {{"weight_bits", bits}, {"weight_scale", scale}};
+}
+
+// fixed-point weights must be integers in the range of weight_type
+template<typename weight_type>
+weight_type weight_from_json(const nlohmann::json& w)
+{
+    if(std::is_integral<weight_type>::value && (!w.is_number_integer() ||
+            w.get<int64_t>() < static_cast<int64_t>(std::numeric_limits<weight_type>::min()) ||
+            w.get<int64_t>() > static_cast<int64_t>(std::numeric_limits<weight_type>::max()))){
+        throw std::invalid_argument("invalid " + std::to_string(sizeof(weight_type) * 8) +
+                "-bit fixed-point weight: " + w.dump());
+    }
+    return w.get<weight_type>();
+}
+
+}
+
+template<typename weight_type>
+void to_json(nlohmann::json& j, const WeightedToken<Word<string_type>, weight_type>& o)
 {
     std::vector<std::string> feature;
-    for(const auto& f: o.token.feature){
+    for(const auto& f: o.token.feature()){
         feature.push_back(cast_string<std::string>(f));
     }
-    j = nlohmann::json{{"t", {{"s", cast_string<std::string>(o.token.surface)}, {"f", feature}}}, {"w", o.weight}};
+    j = nlohmann::json{{"t", {{"s", cast_string<std::string>(o.token.surface())}, {"f", feature}}}, {"w", o.weight}};
 }
 
-void from_json(const nlohmann::json& j, typename WeightedSequenceBuilder<WordPreprocessor<string_type>, WordWeight>::token_type& o)
+template<typename weight_type>
+void from_json(const nlohmann::json& j, WeightedToken<Word<string_type>, weight_type>& o)
 {
-    o.token.surface = cast_string<string_type>(j.at("t").at("s").get<std::string>());
-    std::vector<std::string> feature = j.at("t").at("f").get<std::vector<std::string>>();
-    o.token.feature.clear();
-    for(const auto& f: feature){
-        o.token.feature.push_back(cast_string<string_type>(f));
+    std::vector<string_type> feature;
+    for(const auto& f: j.at("t").at("f").get<std::vector<std::string>>()){
+        feature.push_back(cast_string<string_type>(f));
     }
-    o.weight = j.at("w").get<double>();
+    o.token = {cast_string<string_type>(j.at("t").at("s").get<std::string>()), feature};
+    o.weight = weight_from_json<weight_type>(j.at("w"));
 }
 
-void to_json(nlohmann::json& j, const typename WeightedSequenceBuilder<PronunciationPreprocessor, LetterWeight<string_type>>::token_type& o)
+template<typename weight_type>
+void to_json(nlohmann::json& j, const WeightedToken<string_type::value_type, weight_type>& o)
 {
     j = nlohmann::json{{"t", cast_string<std::string>(string_type(1, o.token))}, {"w", o.weight}};
 }
 
-void from_json(const nlohmann::json& j, typename WeightedSequenceBuilder<PronunciationPreprocessor, LetterWeight<string_type>>::token_type& o)
+template<typename weight_type>
+void from_json(const nlohmann::json& j, WeightedToken<string_type::value_type, weight_type>& o)
 {
-    o.token = cast_string<RomajiPreprocessor::output_type>(j.at("t").get<std::string>())[0];
-    o.weight = j.at("w").get<double>();
+    o.token = cast_string<string_type>(j.at("t").get<std::string>())[0];
+    o.weight = weight_from_json<weight_type>(j.at("w"));
 }
 
-void to_json(nlohmann::json& j, const typename WeightedSequenceBuilder<RomajiPreprocessor, RomajiWeight>::token_type& o)
+template<typename weight_type>
+std::string weight_format_header()
 {
-    j = nlohmann::json{{"t", cast_string<std::string>(string_type(1, o.token))}, {"w", o.weight}};
+    return comment_prefix<char>() + weight_format<weight_type>().dump();
 }
 
-void from_json(const nlohmann::json& j, typename WeightedSequenceBuilder<RomajiPreprocessor, RomajiWeight>::token_type& o)
+template<typename weight_type>
+void check_weight_format(const std::string& index_path)
 {
-    o.token = cast_string<RomajiPreprocessor::output_type>(j.at("t").get<std::string>())[0];
-    o.weight = j.at("w").get<double>();
+    std::ifstream ifs(index_path);
+    if(ifs.fail()){
+        return;
+    }
+
+    std::string line;
+    std::getline(ifs, line);
+    auto stored = weight_format<double>();
+    if(line.size() > 1 && line[0] == comment_prefix<char>() && line[1] == '{'){
+        auto header = nlohmann::json::parse(line.substr(1));
+        if(header.count("weight_bits") > 0){
+            stored = header;
+        }
+    }
+
+    auto expected = weight_format<weight_type>();
+    if(stored.at("weight_bits") != expected.at("weight_bits") ||
+            stored.at("weight_scale") != expected.at("weight_scale")){
+        throw std::runtime_error("weights in " + index_path + " are stored as " + stored.dump() +
+                ", but " + expected.dump() + " is required. rebuild the index with the same weight_bits");
+    }
 }
 
+template void to_json(nlohmann::json& j, const WeightedToken<Word<string_type>, double>& o);
+template void from_json(const nlohmann::json& j, WeightedToken<Word<string_type>, double>& o);
+template void to_json(nlohmann::json& j, const WeightedToken<Word<string_type>, int16_t>& o);
+template void from_json(const nlohmann::json& j, WeightedToken<Word<string_type>, int16_t>& o);
+template void to_json(nlohmann::json& j, const WeightedToken<Word<string_type>, int32_t>& o);
+template void from_json(const nlohmann::json& j, WeightedToken<Word<string_type>, int32_t>& o);
+
+template void to_json(nlohmann::json& j, const WeightedToken<string_type::value_type, double>& o);
+template void from_json(const nlohmann::json& j, WeightedToken<string_type::value_type, double>& o);
+template void to_json(nlohmann::json& j, const WeightedToken<string_type::value_type, int16_t>& o);
+template void from_json(const nlohmann::json& j, WeightedToken<string_type::value_type, int16_t>& o);
+template void to_json(nlohmann::json& j, const WeightedToken<string_type::value_type, int32_t>& o);
+template void from_json(const nlohmann::json& j, WeightedToken<string_type::value_type, int32_t>& o);
+
+template std::string weight_format_header<double>();
+template std::string weight_format_header<int16_t>();
+template std::string weight_format_header<int32_t>();
+
+template void check_weight_format<double>(const std::string& index_path);
+template void check_weight_format<int16_t>(const std::string& index_path);
+template void check_weight_format<int32_t>(const std::string& index_path);
+
 }
@@ -20,6 +20,8 @@ limitations under the License.
 #ifndef RESEMBLA_WEIGHTED_SEQUENCE_SERIALIZER_HPP
 #define RESEMBLA_WEIGHTED_SEQUENCE_SERIALIZER_HPP
 
+#include <string>
+
 #include <json.hpp>
 
 #include "weighted_sequence_builder.hpp"
@@ -33,27 +35,25 @@ limitations under the License.
 
 namespace resembla {
 
-/* TODO: implement as template functions if possible
-template<typename SequenceTokenizer, typename WeightFunction>
-void to_json(nlohmann::json& j, const typename WeightedSequenceBuilder<SequenceTokenizer, WeightFunction>::token_type& o) {
-    j = nlohmann::json{{"token", cast_string<std::string>(string_type(1, o.token))}, {"weight", o.weight}};
-}
-
-template<typename SequenceTokenizer, typename WeightFunction>
-void from_json(const nlohmann::json& j, typename WeightedSequenceBuilder<SequenceTokenizer, WeightFunction>::token_type& o) {
-    o.token = cast_string<SequenceTokenizer::output_type>(j.at("token").get<std::string>())[0];
-    o.weight = j.at("weight").get<double>();
-}
-*/
-
-void to_json(nlohmann::json& j, const typename WeightedSequenceBuilder<WordPreprocessor<string_type>, WordWeight>::token_type& o);
-void from_json(const nlohmann::json& j, typename WeightedSequenceBuilder<WordPreprocessor<string_type>, WordWeight>::token_type& o);
-
-void to_json(nlohmann::json& j, const typename WeightedSequenceBuilder<PronunciationPreprocessor, LetterWeight<string_type>>::token_type& o);
-void from_json(const nlohmann::json& j, typename WeightedSequenceBuilder<PronunciationPreprocessor, LetterWeight<string_type>>::token_type& o);
-
-void to_json(nlohmann::json& j, const typename WeightedSequenceBuilder<RomajiPreprocessor, RomajiWeight>::token_type& o);
-void from_json(const nlohmann::json& j, typename WeightedSequenceBuilder<RomajiPreprocessor, RomajiWeight>::token_type& o);
+// tokens of pronunciation and romaji sequences are letters, and weights are double, int16_t or int32_t
+template<typename weight_type>
+void to_json(nlohmann::json& j, const WeightedToken<Word<string_type>, weight_type>& o);
+template<typename weight_type>
+void from_json(const nlohmann::json& j, WeightedToken<Word<string_type>, weight_type>& o);
+
+template<typename weight_type>
+void to_json(nlohmann::json& j, const WeightedToken<string_type::value_type, weight_type>& o);
+template<typename weight_type>
+void from_json(const nlohmann::json& j, WeightedToken<string_type::value_type, weight_type>& o);
+
+// indexes of weighted sequences start with a comment line recording how weights are stored.
+// indexes without the line are regarded as storing double weights
+template<typename weight_type>
+std::string weight_format_header();
+
+// throws std::runtime_error if the index at index_path stores weights in another format
+template<typename weight_type>
+void check_weight_format(const std::string& index_path);
 
 }
 #endif
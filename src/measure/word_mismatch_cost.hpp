@@ -20,8 +20,8 @@ limitations under the License.
 #ifndef RESEMBLA_WORD_MISMATCH_COST_HPP
 #define RESEMBLA_WORD_MISMATCH_COST_HPP
 
-#include <algorithm>
-#include <iterator>
+#include <cstdint>
+#include <vector>
 
 #include "../word.hpp"
 
@@ -35,42 +35,66 @@ public:
 
     double operator()(const Word<string_type>& reference, const Word<string_type>& target) const
     {
-        auto no_pronunciation = cast_string<string_type>("*");
-
-        if(reference.surface == target.surface){
+        if(reference.is_same_surface(target)){
             return 0.0;
         }
-        else if((!reference.feature[6].empty() && reference.feature[6] != no_pronunciation &&
-                    reference.feature[6] == target.feature[6]) ||
-                (!reference.feature[7].empty() && reference.feature[7] != no_pronunciation &&
-                    reference.feature[7] == target.feature[7])){
+        else if(reference.is_homonym(target)){
             return homonym_cost;
         }
+        else if(reference.dictionary() != nullptr && reference.dictionary() == target.dictionary()){
+            return cached_symbol_distance(reference.signature(), target.signature(), reference.dictionary()->id());
+        }
         else{
-            // compute symbol-based distance
-            auto a = reference.surface, b = target.surface;
-            std::sort(std::begin(a), std::end(a));
-            std::sort(std::begin(b), std::end(b));
-            size_t total = a.length() + b.length(), i = 0, j = 0, c = total;
-            while(i < a.length() && j < b.length()){
-                if(a[i] == b[j]){
-                    ++i;
-                    ++j;
-                    c -= 2;
-                }
-                else if(a[i] < b[j]){
-                    ++i;
-                }
-                else{
-                    ++j;
-                }
-            }
-            return c / static_cast<double>(total);
+            return symbol_distance(*reference.signature(), *target.signature());
         }
     }
 
 private:
     const double homonym_cost;
+
+    static const size_t CACHE_SIZE = 4096;
+
+    // results for words of the same dictionary are cached for each thread,
+    // since the same pairs of words appear repeatedly in reranking
+    static double cached_symbol_distance(const string_type* a, const string_type* b, size_t dictionary_id)
+    {
+        struct CacheEntry
+        {
+            const string_type* a;
+            const string_type* b;
+            size_t dictionary_id;
+            double distance;
+        };
+        thread_local std::vector<CacheEntry> cache(CACHE_SIZE, CacheEntry{nullptr, nullptr, 0, 0.0});
+
+        auto key = reinterpret_cast<uintptr_t>(a) * 31 + reinterpret_cast<uintptr_t>(b);
+        auto& entry = cache[(key >> 4) % CACHE_SIZE];
+        if(entry.a == a && entry.b == b && entry.dictionary_id == dictionary_id){
+            return entry.distance;
+        }
+        entry = {a, b, dictionary_id, symbol_distance(*a, *b)};
+        return entry.distance;
+    }
+
+    // symbol-based distance between sorted surfaces
+    static double symbol_distance(const string_type& a, const string_type& b)
+    {
+        size_t total = a.length() + b.length(), i = 0, j = 0, c = total;
+        while(i < a.length() && j < b.length()){
+            if(a[i] == b[j]){
+                ++i;
+                ++j;
+                c -= 2;
+            }
+            else if(a[i] < b[j]){
+                ++i;
+            }
+            else{
+                ++j;
+            }
+        }
+        return c / static_cast<double>(total);
+    }
 };
 
 }
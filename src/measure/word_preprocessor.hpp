@@ -22,7 +22,6 @@ limitations under the License.
 
 #include <memory>
 #include <string>
-#include <mutex>
 
 #include <mecab.h>
 
@@ -39,56 +38,42 @@ public:
     using token_type = Word<string_type>;
     using output_type = std::vector<token_type>;
 
-    WordPreprocessor(const std::string& mecab_options = "", size_t min_feature_size = 9):
-            tagger(MeCab::createTagger(validate_mecab_options(mecab_options).c_str())),
-            min_feature_size(min_feature_size){}
+    // only feature_columns of features are extracted, or all columns if it is empty
+    WordPreprocessor(const std::string& mecab_options = "", size_t min_feature_size = 9,
+            const std::vector<size_t>& feature_columns = {}):
+            tagger(std::make_shared<MeCabTagger>(mecab_options)), extract_feature(feature_columns, min_feature_size),
+            dictionary(std::make_shared<WordDictionary<string_type>>()) {}
     WordPreprocessor(const WordPreprocessor& obj) = default;
 
-    // parses to a sequence of words
+    // parses to a sequence of words. words of queries refer to strings of the corpus if they are known
     output_type operator()(const string_type& text, bool is_original = false) const
     {
-        (void)is_original;
-
-        std::string text_string = cast_string<std::string>(text);
         output_type s;
-        {
-            std::lock_guard<std::mutex> lock(mutex_tagger);
-            for(const MeCab::Node* node = tagger->parseToNode(text_string.c_str()); node; node = node->next){
-                // skip BOS/EOS nodes
-                if(node->stat == MECAB_BOS_NODE || node->stat == MECAB_EOS_NODE){
-                    continue;
-                }
-
-                // extract surface and features
-                string_type surface = cast_string<string_type>(std::string(node->surface, node->surface + node->length));
-                std::vector<string_type> feature;
-                const char *start = node->feature;
-                for(const char* end = start; *end != '\0'; ++end){
-                    if(*end == ','){
-                        if(start < end){
-                            feature.push_back(cast_string<string_type>(std::string(start, end)));
-                        }
-                        start = end + 1;
-                    }
-                }
-                if(*start != '\0'){
-                    feature.push_back(cast_string<string_type>(std::string(start)));
-                }
-                while(feature.size() < min_feature_size){
-                    feature.push_back(string_type());
-                }
-
-                s.push_back({surface, feature});
+        tagger->parse(cast_string<std::string>(text), [this, is_original, &s](const MeCabNode& node){
+            auto surface = cast_string<string_type>(node.surface, node.surface + node.length);
+            if(is_original){
+                s.emplace_back(surface, extract_feature(node.feature));
+            }
+            else{
+                s.push_back(dictionary->find(surface, extract_feature(node.feature)));
             }
-        }
+        });
         return s;
     }
 
+    // shares strings among words of the corpus
+    token_type intern(const token_type& word) const
+    {
+        return dictionary->intern(word);
+    }
+
 protected:
-    std::shared_ptr<MeCab::Tagger> tagger;
-    mutable std::mutex mutex_tagger;
+    std::shared_ptr<MeCabTagger> tagger;
+
+    const MeCabFeatureColumns<string_type> extract_feature;
 
-    const size_t min_feature_size;
+    // words of the corpus
+    std::shared_ptr<WordDictionary<string_type>> dictionary;
 };
 
 }
@@ -21,6 +21,18 @@ limitations under the License.
 
 namespace resembla {
 
+namespace {
+
+const string_type NOUN = cast_string<string_type>("名詞");
+const string_type VERB = cast_string<string_type>("動詞");
+const string_type ADJECTIVE = cast_string<string_type>("形容詞");
+const string_type SUFFIX = cast_string<string_type>("接尾");
+const string_type DEPENDENT = cast_string<string_type>("非自立");
+const string_type ADVERBIAL = cast_string<string_type>("副詞可能");
+const string_type PRONOUN = cast_string<string_type>("代名詞");
+
+}
+
 WordWeight::WordWeight(double base_weight, double delete_insert_ratio,
         double noun_coefficient, double verb_coefficient, double adj_coefficient):
     base_weight(base_weight), delete_insert_ratio(delete_insert_ratio),
@@ -32,25 +44,26 @@ double WordWeight::operator()(const Word<string_type>& word, bool is_original, s
     double weight = base_weight;
 
     // TODO: parameterize values
-    if(word.feature[7].empty() || word.feature[7] == L"*"){
-        weight *= word.surface.length();
+    if(word.pronunciation() == nullptr){
+        weight *= word.surface().length();
     }
     else{
-        weight *= word.feature[7].length();
+        weight *= word.pronunciation()->length();
     }
 
     if(is_original){
         weight *= delete_insert_ratio;
     }
 
-    if(word.feature[0] == L"名詞" && word.feature[1] != L"接尾" && word.feature[1] != L"非自立" &&
-            word.feature[1] != L"副詞可能" && word.feature[1] != L"代名詞"){
+    const auto& feature = word.feature();
+    if(feature[0] == NOUN && feature[1] != SUFFIX && feature[1] != DEPENDENT &&
+            feature[1] != ADVERBIAL && feature[1] != PRONOUN){
         weight *= noun_coefficient;
     }
-    else if(word.feature[0] == L"動詞" && word.feature[1] != L"接尾" && word.feature[1] != L"非自立"){
+    else if(feature[0] == VERB && feature[1] != SUFFIX && feature[1] != DEPENDENT){
         weight *= verb_coefficient;
     }
-    else if(word.feature[0] == L"形容詞"){
+    else if(feature[0] == ADJECTIVE){
         weight *= adj_coefficient;
     }
 
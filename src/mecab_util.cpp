@@ -21,6 +21,7 @@ limitations under the License.
 
 #include <fstream>
 #include <stdexcept>
+#include <unordered_map>
 
 #include "string_util.hpp"
 
@@ -53,4 +54,81 @@ const std::string& validate_mecab_options(const std::string& mecab_options)
     return mecab_options;
 }
 
+std::shared_ptr<MeCab::Model> shared_mecab_model(const std::string& mecab_options)
+{
+    static std::unordered_map<std::string, std::weak_ptr<MeCab::Model>> models;
+    static std::mutex mutex_models;
+
+    std::lock_guard<std::mutex> lock(mutex_models);
+    auto& entry = models[mecab_options];
+    auto model = entry.lock();
+    if(model == nullptr){
+        model.reset(MeCab::createModel(validate_mecab_options(mecab_options).c_str()));
+        if(model == nullptr){
+            throw std::runtime_error(std::string("failed to load MeCab model: ") + MeCab::getLastError());
+        }
+        entry = model;
+    }
+    return model;
+}
+
+namespace {
+
+// analyses of texts in the scopes of the current thread
+struct AnalysisContext
+{
+    size_t depth = 0;
+    std::unordered_map<std::string, MeCabAnalysisScope::Analysis> analyses;
+};
+
+thread_local AnalysisContext analysis_context;
+
+}
+
+MeCabAnalysisScope::MeCabAnalysisScope()
+{
+    ++analysis_context.depth;
+}
+
+MeCabAnalysisScope::~MeCabAnalysisScope()
+{
+    // analyses are kept until the outermost scope ends
+    if(--analysis_context.depth == 0){
+        analysis_context.analyses.clear();
+    }
+}
+
+MeCabAnalysisScope::Analysis* MeCabAnalysisScope::find(const std::string& mecab_options, const std::string& text)
+{
+    if(analysis_context.depth == 0){
+        return nullptr;
+    }
+    return &analysis_context.analyses[mecab_options + '\0' + text];
+}
+
+MeCabTagger::MeCabTagger(const std::string& mecab_options):
+    mecab_options(validate_mecab_options(mecab_options)),
+    model(shared_mecab_model(mecab_options)), tagger(model->createTagger())
+{}
+
+MeCabTagger::Lease::Lease(const MeCabTagger& owner): owner(owner)
+{
+    {
+        std::lock_guard<std::mutex> lock(owner.mutex_lattices);
+        if(!owner.lattices.empty()){
+            lattice = std::move(owner.lattices.back());
+            owner.lattices.pop_back();
+        }
+    }
+    if(lattice == nullptr){
+        lattice.reset(owner.model->createLattice());
+    }
+}
+
+MeCabTagger::Lease::~Lease()
+{
+    std::lock_guard<std::mutex> lock(owner.mutex_lattices);
+    owner.lattices.push_back(std::move(lattice));
+}
+
 }
@@ -21,10 +21,210 @@ limitations under the License.
 #define RESEMBLA_MECAB_UTIL_HPP
 
 #include <string>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <algorithm>
+
+#include <mecab.h>
+
+#include "string_util.hpp"
 
 namespace resembla {
 
 const std::string& validate_mecab_options(const std::string& mecab_options);
 
+// returns the model loaded with mecab_options. a dictionary is loaded once per process
+// and shared while any of its users remains
+std::shared_ptr<MeCab::Model> shared_mecab_model(const std::string& mecab_options);
+
+// a morpheme given by MeCabTagger. surface and feature are valid only in the callback
+struct MeCabNode
+{
+    const char* surface;
+    size_t length;
+    const char* feature;
+};
+
+// calls f(column, begin, end) for each field of a comma-separated feature given by MeCab
+// until f returns false. empty fields are skipped and not counted as columns
+template<typename Function>
+void scan_mecab_feature(const char* feature, Function f)
+{
+    size_t column = 0;
+    for(const char *start = feature, *end = feature; ; ++end){
+        if(*end == ',' || *end == '\0'){
+            if(start < end){
+                if(!f(column, start, end)){
+                    return;
+                }
+                ++column;
+            }
+            if(*end == '\0'){
+                return;
+            }
+            start = end + 1;
+        }
+    }
+}
+
+// extracts columns of features in place, and converts only the requested ones to string_type
+template<typename string_type>
+class MeCabFeatureColumns
+{
+public:
+    using feature_type = std::vector<string_type>;
+
+    // extracts all columns if columns is empty. results are padded with empty strings up to min_size
+    MeCabFeatureColumns(std::vector<size_t> columns = {}, size_t min_size = 0):
+        columns(sorted(std::move(columns))), min_size(min_size)
+    {}
+
+    // columns which are not requested are left empty
+    feature_type operator()(const char* feature) const
+    {
+        feature_type result;
+        auto next = std::begin(columns);
+        scan_mecab_feature(feature, [this, &result, &next](size_t column, const char* begin, const char* end){
+            if(columns.empty()){
+                result.push_back(cast_string<string_type>(begin, end));
+                return true;
+            }
+            if(column == *next){
+                result.resize(column + 1);
+                cast_string(begin, end, result.back());
+                ++next;
+            }
+            return next != std::end(columns);
+        });
+        if(result.size() < min_size){
+            result.resize(min_size);
+        }
+        return result;
+    }
+
+    // a column of feature, which is empty if not found
+    static string_type column(const char* feature, size_t pos)
+    {
+        string_type result;
+        scan_mecab_feature(feature, [pos, &result](size_t column, const char* begin, const char* end){
+            if(column < pos){
+                return true;
+            }
+            cast_string(begin, end, result);
+            return false;
+        });
+        return result;
+    }
+
+protected:
+    const std::vector<size_t> columns;
+    const size_t min_size;
+
+    static std::vector<size_t> sorted(std::vector<size_t> columns)
+    {
+        std::sort(std::begin(columns), std::end(columns));
+        columns.erase(std::unique(std::begin(columns), std::end(columns)), std::end(columns));
+        return columns;
+    }
+};
+
+// while an instance lives, each text is parsed once on the current thread by all MeCabTaggers
+// of the same options, so that measures of an ensemble share the analysis of a query
+class MeCabAnalysisScope
+{
+public:
+    // pairs of surface and feature
+    using Analysis = std::vector<std::pair<std::string, std::string>>;
+
+    MeCabAnalysisScope();
+    ~MeCabAnalysisScope();
+    MeCabAnalysisScope(const MeCabAnalysisScope&) = delete;
+    MeCabAnalysisScope& operator=(const MeCabAnalysisScope&) = delete;
+
+    // analysis of text in the innermost scope of the current thread, which is empty until filled.
+    // returns nullptr if no scope is open
+    static Analysis* find(const std::string& mecab_options, const std::string& text);
+};
+
+// parses texts on any number of threads at once. all threads share one tagger on the shared model,
+// and each parse borrows a lattice from a pool, so that parsing is not serialized
+class MeCabTagger
+{
+public:
+    MeCabTagger(const std::string& mecab_options = "");
+    MeCabTagger(const MeCabTagger&) = delete;
+    MeCabTagger& operator=(const MeCabTagger&) = delete;
+
+    // calls f for each node of text except BOS/EOS nodes
+    template<typename Function>
+    void parse(const std::string& text, Function f) const
+    {
+        auto analysis = MeCabAnalysisScope::find(mecab_options, text);
+        if(analysis == nullptr){
+            parse_lattice(text, f);
+            return;
+        }
+
+        if(analysis->empty()){
+            parse_lattice(text, [analysis](const MeCabNode& node){
+                analysis->emplace_back(std::string(node.surface, node.length), std::string(node.feature));
+            });
+        }
+        for(const auto& morpheme: *analysis){
+            f(MeCabNode{morpheme.first.data(), morpheme.first.length(), morpheme.second.c_str()});
+        }
+    }
+
+protected:
+    // returns a lattice to the pool on destruction
+    class Lease
+    {
+    public:
+        Lease(const MeCabTagger& owner);
+        ~Lease();
+
+        MeCab::Lattice* get() const
+        {
+            return lattice.get();
+        }
+
+        MeCab::Lattice* operator->() const
+        {
+            return lattice.get();
+        }
+
+    protected:
+        const MeCabTagger& owner;
+        std::unique_ptr<MeCab::Lattice> lattice;
+    };
+
+    const std::string mecab_options;
+
+    std::shared_ptr<MeCab::Model> model;
+    std::shared_ptr<MeCab::Tagger> tagger;
+
+    mutable std::vector<std::unique_ptr<MeCab::Lattice>> lattices;
+    mutable std::mutex mutex_lattices;
+
+    template<typename Function>
+    void parse_lattice(const std::string& text, Function f) const
+    {
+        Lease lattice(*this);
+        lattice->set_sentence(text.c_str(), text.length());
+        if(!tagger->parse(lattice.get())){
+            throw std::runtime_error(std::string("failed to parse text by MeCab: ") + lattice->what());
+        }
+        for(const MeCab::Node* node = lattice->bos_node(); node; node = node->next){
+            if(node->stat == MECAB_BOS_NODE || node->stat == MECAB_EOS_NODE){
+                continue;
+            }
+            f(MeCabNode{node->surface, node->length, node->feature});
+        }
+    }
+};
+
 }
 #endif
@@ -0,0 +1,87 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_MEMORY_USAGE_HPP
+#define RESEMBLA_MEMORY_USAGE_HPP
+
+#include <string>
+#include <vector>
+
+namespace resembla {
+
+// rough estimation of memory consumed by a value including its heap allocations
+template<typename T>
+size_t memory_usage(const T& value);
+
+template<typename C, typename T, typename A>
+size_t memory_usage(const std::basic_string<C, T, A>& s)
+{
+    return sizeof(s) + s.capacity() * sizeof(C);
+}
+
+template<typename T, typename A>
+size_t memory_usage(const std::vector<T, A>& v)
+{
+    size_t usage = sizeof(v) + (v.capacity() - v.size()) * sizeof(T);
+    for(const auto& e: v){
+        usage += memory_usage(e);
+    }
+    return usage;
+}
+
+// tokens with weights
+template<typename T>
+auto memory_usage_of_members(const T& value, int) -> decltype(value.token, value.weight, size_t())
+{
+    return sizeof(value) - sizeof(value.token) + memory_usage(value.token);
+}
+
+// texts with keywords
+template<typename T>
+auto memory_usage_of_members(const T& value, int) -> decltype(value.text, value.keywords, size_t())
+{
+    return sizeof(value) - sizeof(value.text) - sizeof(value.keywords) +
+        memory_usage(value.text) + memory_usage(value.keywords);
+}
+
+// words, which own their strings unless they refer to a dictionary
+template<typename T>
+auto memory_usage_of_members(const T& value, int) -> decltype(value.dictionary(), value.surface(), value.feature(), size_t())
+{
+    if(value.dictionary() != nullptr){
+        return sizeof(value);
+    }
+    return sizeof(value) + memory_usage(value.surface()) + memory_usage(value.feature()) + memory_usage(*value.signature());
+}
+
+// other values
+template<typename T>
+size_t memory_usage_of_members(const T& value, long)
+{
+    return sizeof(value);
+}
+
+template<typename T>
+size_t memory_usage(const T& value)
+{
+    return memory_usage_of_members(value, 0);
+}
+
+}
+#endif
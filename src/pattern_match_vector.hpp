@@ -0,0 +1,115 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_PATTERN_MATCH_VECTOR_HPP
+#define RESEMBLA_PATTERN_MATCH_VECTOR_HPP
+
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+namespace resembla {
+
+// bit vectors of positions where each symbol appears in a pattern, used by bit-parallel algorithms.
+// positions are split into blocks of bitvector_type
+template<typename string_type, typename bitvector_type = uint64_t>
+class PatternMatchVector
+{
+public:
+    using size_type = typename string_type::size_type;
+    using symbol_type = typename string_type::value_type;
+
+    static constexpr size_type BLOCK_WIDTH = 8 * sizeof(bitvector_type);
+
+    PatternMatchVector(const string_type& pattern):
+        block_size(pattern.empty() ? 0 : (pattern.length() - 1) / BLOCK_WIDTH + 1), zeroes(block_size, 0)
+    {
+        if(pattern.empty()){
+            return;
+        }
+
+        std::map<symbol_type, std::vector<bitvector_type>> PM_work;
+        for(size_type i = 0; i < pattern.length(); ++i){
+            auto& v = PM_work[pattern[i]];
+            if(v.empty()){
+                v.resize(block_size, 0);
+            }
+            v[i / BLOCK_WIDTH] |= bitvector_type{1} << (i % BLOCK_WIDTH);
+        }
+
+        PM.resize(PM_work.size());
+        std::copy(std::begin(PM_work), std::end(PM_work), std::begin(PM));
+        c_min = PM.front().first;
+        c_max = PM.back().first;
+    }
+
+    size_type blocks() const
+    {
+        return block_size;
+    }
+
+    // bit vectors of c, or zeroes if c does not appear in the pattern
+    const std::vector<bitvector_type>& operator[](const symbol_type c) const
+    {
+        if(PM.empty() || c < c_min || c_max < c){
+            return zeroes;
+        }
+        else if(c == c_min){
+            return PM.front().second;
+        }
+        else if(c == c_max){
+            return PM.back().second;
+        }
+
+        size_type l = 1, r = PM.size() - 1;
+        while(r - l > 8){
+            auto i = (l + r) / 2;
+            if(PM[i].first < c){
+                l = i + 1;
+            }
+            else if(PM[i].first > c){
+                r = i;
+            }
+            else{
+                return PM[i].second;
+            }
+        }
+
+        for(size_type i = l; i < r; ++i){
+            if(PM[i].first == c){
+                return PM[i].second;
+            }
+        }
+
+        return zeroes;
+    }
+
+protected:
+    size_type block_size;
+    std::vector<std::pair<symbol_type, std::vector<bitvector_type>>> PM;
+    std::vector<bitvector_type> zeroes;
+    symbol_type c_min, c_max;
+};
+
+template<typename string_type, typename bitvector_type>
+constexpr typename PatternMatchVector<string_type, bitvector_type>::size_type PatternMatchVector<string_type, bitvector_type>::BLOCK_WIDTH;
+
+}
+#endif
@@ -27,7 +27,7 @@ namespace resembla {
 
 TextClassificationFeatureExtractor::TextClassificationFeatureExtractor(
         const std::string& mecab_options, const std::string& dict_path, const std::string& model_path):
-    tagger(MeCab::createTagger(validate_mecab_options(mecab_options).c_str())),
+    tagger(std::make_shared<MeCabTagger>(mecab_options)),
     model(svm_load_model(model_path.c_str()))
 {
     for(const auto& columns: CsvReader<>(dict_path, 2)){
@@ -50,30 +50,21 @@ Feature::text_type TextClassificationFeatureExtractor::operator()(const string_t
 
 std::vector<svm_node> TextClassificationFeatureExtractor::toNodes(const string_type& text) const
 {
-    const auto text_string = cast_string<std::string>(text);
     BoW bow;
-    {
-        std::lock_guard<std::mutex> lock(mutex_tagger);
-        for(const auto* node = tagger->parseToNode(text_string.c_str()); node; node = node->next){
-            // skip BOS/EOS nodes
-            if(node->stat == MECAB_BOS_NODE || node->stat == MECAB_EOS_NODE){
-                continue;
-            }
-
-            auto i = dictionary.find(std::string(node->surface, node->surface + node->length));
-            if(i == dictionary.end()){
-                continue;
-            }
+    tagger->parse(cast_string<std::string>(text), [this, &bow](const MeCabNode& node){
+        auto i = dictionary.find(std::string(node.surface, node.surface + node.length));
+        if(i == dictionary.end()){
+            return;
+        }
 
-            auto j = bow.find(i->second);
-            if(j == bow.end()){
-                bow[i->second] = 1;
-            }
-            else{
-                ++j->second;
-            }
+        auto j = bow.find(i->second);
+        if(j == bow.end()){
+            bow[i->second] = 1;
         }
-    }
+        else{
+            ++j->second;
+        }
+    });
 
     std::vector<svm_node> nodes(bow.size() + 1);
     size_t i = 0;
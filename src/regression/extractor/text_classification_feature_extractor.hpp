@@ -26,10 +26,10 @@ limitations under the License.
 #include <memory>
 #include <mutex>
 
-#include <mecab.h>
 #include <libsvm/svm.h>
 
 #include "feature_extractor.hpp"
+#include "../../mecab_util.hpp"
 
 namespace resembla {
 
@@ -45,8 +45,7 @@ protected:
 
     std::unordered_map<std::string, int> dictionary;
 
-    std::shared_ptr<MeCab::Tagger> tagger;
-    mutable std::mutex mutex_tagger;
+    std::shared_ptr<MeCabTagger> tagger;
 
     svm_model *model;
     mutable std::mutex mutex_model;
@@ -22,6 +22,13 @@ limitations under the License.
 
 #include <vector>
 #include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+#include "thread_pool.hpp"
 
 #ifdef DEBUG
 #include <string>
@@ -37,6 +44,11 @@ class Reranker
 public:
     using output_type = std::pair<Original, double>;
 
+    // candidates are scored on pool if their number is min_parallel_size or more
+    Reranker(std::shared_ptr<ThreadPool> pool = nullptr, size_t min_parallel_size = 0):
+        pool(pool), min_parallel_size(min_parallel_size)
+    {}
+
     template<typename Iterator, typename ScoreFunction>
     std::vector<output_type> rerank(
         const typename std::iterator_traits<Iterator>::value_type& target,
@@ -46,45 +58,289 @@ public:
     ) const
     {
 #ifdef DEBUG
-        std::cerr << "DEBUG: " << "target=" << cast_string<std::string>(target.first) << std::endl;
+        std::cerr << "DEBUG: " << "target=" << cast_string<std::string>(view(target.first)) << std::endl;
         std::cerr << "DEBUG: " << "===========before reranking=============" << std::endl;
         for(auto i = begin; i != end; ++i){
-            std::cerr << "DEBUG: " << cast_string<std::string>(i->first) << std::endl;
+            std::cerr << "DEBUG: " << cast_string<std::string>(view(i->first)) << std::endl;
         }
         std::cerr << "DEBUG: " << "start reranking: threshold==" << threshold << ", max_output=" << max_output << std::endl;
 #endif
-        std::vector<output_type> result;
-        for(auto i = begin; i != end; ++i){
-            auto score = score_func(target.second, i->second);
-            if(threshold == 0.0 || score >= threshold){
-                result.push_back(std::make_pair(i->first, score));
-            }
-        }
+        const auto& scorer = prepare(score_func, view(target.second), 0);
+        size_t num_pruned = 0;
+        auto candidates = score(target, begin, end, scorer, threshold, max_output, num_pruned,
+                typename std::iterator_traits<Iterator>::iterator_category());
+#ifdef DEBUG
+        auto num_candidates = std::distance(begin, end);
+        std::cerr << "DEBUG: " << "pruned by upper bounds: " << num_pruned << " of " << num_candidates <<
+            " candidates, prune_rate=" << (num_candidates > 0 ? static_cast<double>(num_pruned) / num_candidates : 0.0) << std::endl;
+#endif
 
-        if(max_output != 0 && result.size() > max_output){
-            std::partial_sort(std::begin(result), std::begin(result) + max_output, std::end(result), Sorter());
-            result.erase(std::begin(result) + max_output, std::end(result));
+        if(max_output != 0 && candidates.size() > max_output){
+            std::partial_sort(std::begin(candidates), std::begin(candidates) + max_output, std::end(candidates));
+            candidates.erase(std::begin(candidates) + max_output, std::end(candidates));
         }
         else{
-            std::sort(std::begin(result), std::end(result), Sorter());
+            std::sort(std::begin(candidates), std::end(candidates));
+        }
+
+        std::vector<output_type> result;
+        for(const auto& c: candidates){
+            result.push_back(std::make_pair(c.i->first, c.score));
         }
 #ifdef DEBUG
         std::cerr << "DEBUG: " << "===========after reranking=============" << std::endl;
         for(const auto& r: result){
-            std::cerr << "DEBUG: " << "text=" << cast_string<std::string>(r.first) << ", score=" << r.second << std::endl;
+            std::cerr << "DEBUG: " << "text=" << cast_string<std::string>(view(r.first)) << ", score=" << r.second << std::endl;
         }
 #endif
         return result;
     }
 
 protected:
-    struct Sorter
+    const std::shared_ptr<ThreadPool> pool;
+    const size_t min_parallel_size;
+
+    template<typename Iterator>
+    struct Candidate
     {
-        bool operator()(const output_type& a, const output_type& b) const
+        Iterator i;
+        size_t position;
+        double score;
+
+        // higher score first, and earlier position first in case of a tie
+        bool operator<(const Candidate& c) const
         {
-            return a.second > b.second;
+            return score > c.score || (score == c.score && position < c.position);
         }
     };
+
+    // score candidates on the calling thread
+    template<typename Iterator, typename ScoreFunction, typename IteratorCategory>
+    std::vector<Candidate<Iterator>> score(
+        const typename std::iterator_traits<Iterator>::value_type& target,
+        Iterator begin, Iterator end,
+        const ScoreFunction& score_func,
+        double threshold, size_t max_output, size_t& num_pruned, IteratorCategory
+    ) const
+    {
+        std::vector<Candidate<Iterator>> candidates;
+        num_pruned = score(target, begin, end, 0, score_func, threshold, max_output, candidates);
+        return candidates;
+    }
+
+    // split candidates into chunks, score them on pool and merge top-k candidates of each chunk
+    template<typename Iterator, typename ScoreFunction>
+    std::vector<Candidate<Iterator>> score(
+        const typename std::iterator_traits<Iterator>::value_type& target,
+        Iterator begin, Iterator end,
+        const ScoreFunction& score_func,
+        double threshold, size_t max_output, size_t& num_pruned, std::random_access_iterator_tag
+    ) const
+    {
+        size_t n = static_cast<size_t>(std::distance(begin, end));
+        if(pool == nullptr || min_parallel_size == 0 || n < min_parallel_size){
+            return score(target, begin, end, score_func, threshold, max_output, num_pruned, std::input_iterator_tag());
+        }
+
+        // a few chunks per thread to balance load between threads
+        size_t num_chunks = (pool->size() + 1) * 4;
+        size_t chunk_size = (n + num_chunks - 1) / num_chunks;
+        if(chunk_size < MIN_CHUNK_SIZE){
+            chunk_size = MIN_CHUNK_SIZE;
+        }
+        std::vector<std::vector<Candidate<Iterator>>> chunks((n + chunk_size - 1) / chunk_size);
+        std::vector<size_t> chunk_pruned(chunks.size(), 0);
+        pool->parallel_for(n, chunk_size, [&](size_t chunk_begin, size_t chunk_end){
+            chunk_pruned[chunk_begin / chunk_size] = score(target, begin + chunk_begin, begin + chunk_end, chunk_begin,
+                    score_func, threshold, max_output, chunks[chunk_begin / chunk_size]);
+        });
+
+        std::vector<Candidate<Iterator>> candidates;
+        for(const auto& chunk: chunks){
+            std::copy(std::begin(chunk), std::end(chunk), std::back_inserter(candidates));
+        }
+        num_pruned = std::accumulate(std::begin(chunk_pruned), std::end(chunk_pruned), size_t{0});
+        return candidates;
+    }
+
+    // keep max_output best candidates in a heap whose top is the worst one.
+    // returns the number of candidates discarded by upper bounds without scoring them
+    template<typename Iterator, typename ScoreFunction>
+    size_t score(
+        const typename std::iterator_traits<Iterator>::value_type& target,
+        Iterator begin, Iterator end, size_t position,
+        const ScoreFunction& score_func,
+        double threshold, size_t max_output,
+        std::vector<Candidate<Iterator>>& candidates
+    ) const
+    {
+        return score_candidates(target, begin, end, position, score_func, threshold, max_output, candidates, 0);
+    }
+
+    // candidates worse than the current k-th one are never returned
+    template<typename Iterator>
+    static double current_min_score(double threshold, size_t max_output, const std::vector<Candidate<Iterator>>& candidates)
+    {
+        double min_score = threshold;
+        if(max_output != 0 && candidates.size() == max_output){
+            min_score = std::max(min_score, candidates.front().score);
+        }
+        return min_score;
+    }
+
+    template<typename Iterator>
+    static void add(const Candidate<Iterator>& c, double threshold, size_t max_output,
+            std::vector<Candidate<Iterator>>& candidates)
+    {
+        if(threshold != 0.0 && c.score < threshold){
+            return;
+        }
+
+        if(max_output == 0){
+            candidates.push_back(c);
+        }
+        else if(candidates.size() < max_output){
+            candidates.push_back(c);
+            std::push_heap(std::begin(candidates), std::end(candidates));
+        }
+        else if(c < candidates.front()){
+            std::pop_heap(std::begin(candidates), std::end(candidates));
+            candidates.back() = c;
+            std::push_heap(std::begin(candidates), std::end(candidates));
+        }
+    }
+
+    // candidates and their data can be given as pointers to avoid copying them
+    template<typename T>
+    static const T& view(const T& value)
+    {
+        return value;
+    }
+
+    template<typename T>
+    static const T& view(const T* value)
+    {
+        return *value;
+    }
+
+    // score functions having batch(a) score groups of candidates at once. the batch scorer keeps
+    // what it computes for the target, so that it is created once for each chunk
+    template<typename Iterator, typename ScoreFunction>
+    auto score_candidates(
+        const typename std::iterator_traits<Iterator>::value_type& target,
+        Iterator begin, Iterator end, size_t position,
+        const ScoreFunction& score_func,
+        double threshold, size_t max_output,
+        std::vector<Candidate<Iterator>>& candidates, int
+    ) const -> decltype(score_func.batch(view(target.second)), size_t())
+    {
+        auto batch = score_func.batch(view(target.second));
+        using batch_type = decltype(batch);
+        using data_type = typename std::decay<decltype(view(begin->second))>::type;
+
+        size_t num_pruned = 0;
+        std::vector<Candidate<Iterator>> group;
+        std::vector<const data_type*> data;
+        double scores[batch_type::LANES];
+        for(auto i = begin; i != end; ){
+            // candidates are pruned one by one, and the rest are scored together
+            for(; i != end && group.size() < batch_type::LANES; ++i, ++position){
+                if(prunable(score_func, view(target.second), view(i->second), current_min_score(threshold, max_output, candidates))){
+                    ++num_pruned;
+                    continue;
+                }
+                group.push_back({i, position, 0.0});
+                data.push_back(&view(i->second));
+            }
+            if(group.empty()){
+                continue;
+            }
+
+            batch(&data[0], data.size(), current_min_score(threshold, max_output, candidates), scores);
+            for(size_t k = 0; k < group.size(); ++k){
+                group[k].score = scores[k];
+                add(group[k], threshold, max_output, candidates);
+            }
+            group.clear();
+            data.clear();
+        }
+        return num_pruned;
+    }
+
+    template<typename Iterator, typename ScoreFunction>
+    size_t score_candidates(
+        const typename std::iterator_traits<Iterator>::value_type& target,
+        Iterator begin, Iterator end, size_t position,
+        const ScoreFunction& score_func,
+        double threshold, size_t max_output,
+        std::vector<Candidate<Iterator>>& candidates, long
+    ) const
+    {
+        size_t num_pruned = 0;
+        for(auto i = begin; i != end; ++i, ++position){
+            double min_score = current_min_score(threshold, max_output, candidates);
+            if(prunable(score_func, view(target.second), view(i->second), min_score)){
+                ++num_pruned;
+                continue;
+            }
+            Candidate<Iterator> c = {i, position, score_with_bound(score_func, view(target.second), view(i->second), min_score, 0)};
+            add(c, threshold, max_output, candidates);
+        }
+        return num_pruned;
+    }
+
+    // score functions having prepare(a) can preprocess the target once and return a function to score candidates
+    template<typename ScoreFunction, typename A>
+    static auto prepare(const ScoreFunction& score_func, const A& a, int) -> decltype(score_func.prepare(a))
+    {
+        return score_func.prepare(a);
+    }
+
+    template<typename ScoreFunction, typename A>
+    static const ScoreFunction& prepare(const ScoreFunction& score_func, const A&, long)
+    {
+        return score_func;
+    }
+
+    // score functions accepting a minimum score may stop computation for candidates below it
+    template<typename ScoreFunction, typename A, typename B>
+    static auto score_with_bound(const ScoreFunction& score_func, const A& a, const B& b, double min_score, int)
+        -> decltype(score_func(a, b, min_score))
+    {
+        return score_func(a, b, min_score);
+    }
+
+    template<typename ScoreFunction, typename A, typename B>
+    static auto score_with_bound(const ScoreFunction& score_func, const A& a, const B& b, double, long)
+        -> decltype(score_func(a, b))
+    {
+        return score_func(a, b);
+    }
+
+    // score functions having upper_bound(a, b) can discard candidates cheaply before scoring them
+    template<typename ScoreFunction, typename A, typename B>
+    static auto upper_bound(const ScoreFunction& score_func, const A& a, const B& b, int)
+        -> decltype(score_func.upper_bound(a, b))
+    {
+        return score_func.upper_bound(a, b);
+    }
+
+    template<typename ScoreFunction, typename A, typename B>
+    static double upper_bound(const ScoreFunction&, const A&, const B&, long)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    template<typename ScoreFunction, typename A, typename B>
+    static bool prunable(const ScoreFunction& score_func, const A& a, const B& b, double min_score)
+    {
+        return min_score > 0.0 && upper_bound(score_func, a, b, 0) + BOUND_TOLERANCE < min_score;
+    }
+
+    static const size_t MIN_CHUNK_SIZE = 16;
+
+    // margin of upper bounds to keep candidates whose score is equal to min_score in spite of rounding errors
+    static constexpr double BOUND_TOLERANCE = 1e-9;
 };
 
 }
@@ -0,0 +1,108 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "resembla_cache.hpp"
+
+namespace resembla {
+
+ResemblaCache::ResemblaCache(const std::shared_ptr<ResemblaInterface> resembla, size_t max_size, double ttl):
+    resembla(resembla),
+    ttl(std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(ttl))),
+    cache(max_size), current_generation(0)
+{}
+
+std::vector<ResemblaCache::output_type> ResemblaCache::find(const string_type& query,
+        double threshold, size_t max_response) const
+{
+    size_t current = current_generation;
+    Key key{query, threshold, max_response};
+
+    std::shared_ptr<const Entry> entry;
+    if(cache.get(key, entry) && entry->generation == current &&
+            (ttl == clock_type::duration::zero() || clock_type::now() < entry->expiration)){
+        return entry->response;
+    }
+
+    // wait for the same request in progress, or execute it here
+    std::promise<std::vector<output_type>> promise;
+    {
+        std::unique_lock<std::mutex> lock(mutex_inflight);
+        auto i = inflight.find(key);
+        if(i != std::end(inflight)){
+            auto response = i->second;
+            lock.unlock();
+            return response.get();
+        }
+        inflight[key] = promise.get_future().share();
+    }
+
+    try{
+        auto response = resembla->find(query, threshold, max_response);
+        if(current == current_generation){
+            cache.put(key, std::make_shared<const Entry>(Entry{response, clock_type::now() + ttl, current}), 1);
+        }
+        promise.set_value(response);
+        std::lock_guard<std::mutex> lock(mutex_inflight);
+        inflight.erase(key);
+        return response;
+    }
+    catch(...){
+        promise.set_exception(std::current_exception());
+        std::lock_guard<std::mutex> lock(mutex_inflight);
+        inflight.erase(key);
+        throw;
+    }
+}
+
+std::vector<ResemblaCache::output_type> ResemblaCache::eval(const string_type& query,
+        const std::vector<string_type>& candidates, double threshold, size_t max_response) const
+{
+    return resembla->eval(query, candidates, threshold, max_response);
+}
+
+size_t ResemblaCache::hits() const
+{
+    return cache.hits();
+}
+
+size_t ResemblaCache::misses() const
+{
+    return cache.misses();
+}
+
+double ResemblaCache::hit_ratio() const
+{
+    return cache.hit_ratio();
+}
+
+void ResemblaCache::clear()
+{
+    ++current_generation;
+    cache.clear();
+}
+
+size_t ResemblaCache::KeyHash::operator()(const Key& k) const
+{
+    size_t h = std::hash<string_type>()(k.query);
+    h ^= std::hash<double>()(k.threshold) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= std::hash<size_t>()(k.max_response) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    return h;
+}
+
+}
@@ -0,0 +1,101 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_RESEMBLA_CACHE_HPP
+#define RESEMBLA_RESEMBLA_CACHE_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <future>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include "resembla_interface.hpp"
+#include "lru_cache.hpp"
+
+namespace resembla {
+
+// caches responses of find() for each combination of query, threshold and max_response.
+// requests for the same key are executed only once even if they arrive at the same time.
+// indexes are loaded only when Resembla is constructed, and a rebuilt index is used after constructing
+// Resembla again with an empty cache. entries expire after ttl in any case
+class ResemblaCache: public ResemblaInterface
+{
+public:
+    // ttl is in seconds. 0 means entries never expire
+    ResemblaCache(const std::shared_ptr<ResemblaInterface> resembla, size_t max_size, double ttl = 0.0);
+
+    std::vector<output_type> find(const string_type& query,
+            double threshold = 0.0, size_t max_response = 0) const;
+
+    // not cached since candidates vary from request to request
+    std::vector<output_type> eval(const string_type& query, const std::vector<string_type>& candidates,
+            double threshold = 0.0, size_t max_response = 0) const;
+
+    size_t hits() const;
+    size_t misses() const;
+    double hit_ratio() const;
+
+    // discards all entries, e.g. after the wrapped instance reloads its indexes.
+    // responses being computed at that time are not cached
+    void clear();
+
+protected:
+    using clock_type = std::chrono::steady_clock;
+
+    struct Key
+    {
+        string_type query;
+        double threshold;
+        size_t max_response;
+
+        bool operator==(const Key& k) const
+        {
+            return query == k.query && threshold == k.threshold && max_response == k.max_response;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& k) const;
+    };
+
+    struct Entry
+    {
+        std::vector<output_type> response;
+        clock_type::time_point expiration;
+        size_t generation;
+    };
+
+    const std::shared_ptr<ResemblaInterface> resembla;
+    const clock_type::duration ttl;
+    mutable LruCache<Key, std::shared_ptr<const Entry>, KeyHash> cache;
+
+    std::atomic<size_t> current_generation;
+
+    mutable std::mutex mutex_inflight;
+    mutable std::unordered_map<Key, std::shared_future<std::vector<output_type>>, KeyHash> inflight;
+};
+
+}
+#endif
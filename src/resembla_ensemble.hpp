@@ -26,6 +26,7 @@ limitations under the License.
 #include <algorithm>
 
 #include "resembla_interface.hpp"
+#include "mecab_util.hpp"
 
 namespace resembla {
 
@@ -56,6 +57,9 @@ public:
     std::vector<output_type> eval(const string_type& query, const std::vector<string_type>& candidates,
             double threshold = 0.0, size_t max_response = 0) const
     {
+        // children parse query by MeCab only once
+        MeCabAnalysisScope scope;
+
         std::unordered_map<string_type, std::vector<double>> work;
         for(const auto& resembla: children){
             for(const auto& r: resembla->eval(query, candidates, 0.0, 0)){
@@ -30,6 +30,8 @@ limitations under the License.
 #include "resembla_interface.hpp"
 #include "csv_reader.hpp"
 #include "reranker.hpp"
+#include "thread_pool.hpp"
+#include "mecab_util.hpp"
 
 #include "regression/feature.hpp"
 #include "regression/extractor/feature_extractor.hpp"
@@ -44,7 +46,8 @@ public:
             std::shared_ptr<Database> database,
             std::shared_ptr<FeatureExtractor> feature_extractor,
             std::shared_ptr<ScoreFunction> score_func,
-            size_t max_candidate = 0, const std::string& index_path = ""):
+            size_t max_candidate = 0, const std::string& index_path = "",
+            std::shared_ptr<ThreadPool> pool = nullptr):
         database(database), preprocess(feature_extractor), score_func(score_func),
         reranker(), max_candidate(max_candidate)
     {
@@ -52,22 +55,26 @@ public:
             return;
         }
 
-        for(const auto& columns: CsvReader<std::string>(index_path, 2)){
-            const auto& original = cast_string<string_type>(columns[1]);
-
-            if(columns.size() > 2 && !columns[2].empty()){
-                const auto& features = columns[2];
-                auto json = nlohmann::json::parse(features);
-                WorkData preprocessed;
-                for(auto i = std::begin(json); i != std::end(json); ++i){
-                    preprocessed[i.key()] = i.value();
+        CsvReader<std::string>(index_path, 2).load(
+            [this](const std::vector<std::string>& columns) -> std::pair<string_type, WorkData>{
+                const auto& original = cast_string<string_type>(columns[1]);
+
+                if(columns.size() > 2 && !columns[2].empty()){
+                    const auto& features = columns[2];
+                    auto json = nlohmann::json::parse(features);
+                    WorkData preprocessed;
+                    for(auto i = std::begin(json); i != std::end(json); ++i){
+                        preprocessed[i.key()] = i.value();
+                    }
+                    return std::make_pair(original, preprocessed);
                 }
-                corpus_features[original] = preprocessed;
-            }
-            else{
-                corpus_features[original] = (*preprocess)(original, "");
-            }
-        }
+                else{
+                    return std::make_pair(original, (*this->preprocess)(original, ""));
+                }
+            },
+            [this](std::pair<string_type, WorkData>& row){
+                corpus_features[row.first] = std::move(row.second);
+            }, pool.get());
     }
 
     void append(const std::string& name, const std::shared_ptr<ResemblaInterface> resembla)
@@ -86,6 +93,9 @@ public:
     std::vector<output_type> eval(const string_type& query, const std::vector<string_type>& candidates,
             double threshold = 0.0, size_t max_response = 0) const
     {
+        // children and feature extractors parse query by MeCab only once
+        MeCabAnalysisScope scope;
+
         std::unordered_map<string_type, StringFeatureMap> candidate_features;
         for(const auto& c: candidates){
             auto i = corpus_features.find(c);
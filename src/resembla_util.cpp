@@ -19,6 +19,9 @@ limitations under the License.
 
 #include "resembla_util.hpp"
 
+#include <cstdint>
+#include <future>
+
 #include <simstring/simstring.h>
 
 #include "simstring_database.hpp"
@@ -48,6 +51,7 @@ limitations under the License.
 
 #include "measure/weighted_l2_norm.hpp"
 #include "resembla_ensemble.hpp"
+#include "resembla_cache.hpp"
 
 #include "regression/extractor/feature_extractor.hpp"
 #include "regression/extractor/regex_feature_extractor.hpp"
@@ -175,14 +179,15 @@ std::vector<measure> split_to_resembla_measures(std::string text, char delimiter
 
 std::shared_ptr<ResemblaRegression<SimStringDatabase<RomajiPreprocessor>, Composition<FeatureAggregator, SVRPredictor>>>
 construct_resembla_regression(const std::string& simstring_db_path, const std::string& resembla_index_path,
-        const paramset::manager& pm, const std::shared_ptr<ResemblaInterface> resembla)
+        const paramset::manager& pm, const std::shared_ptr<ResemblaInterface> resembla,
+        std::shared_ptr<ThreadPool> pool)
 {
     auto indexer = std::make_shared<RomajiPreprocessor>(pm.get<std::string>("index_romaji_mecab_options"),
             pm.get<int>("index_romaji_mecab_feature_pos"),
             pm.get<std::string>("index_romaji_mecab_pronunciation_of_marks"));
     auto database = std::make_shared<SimStringDatabase<RomajiPreprocessor>>(simstring_db_path,
             pm.get<int>("simstring_measure"), pm.get<double>("ed_simstring_threshold"),
-            indexer, resembla_index_path);
+            indexer, resembla_index_path, pool);
 
     auto features = load_features(pm.get<std::string>("svr_features_path"));
     if(features.empty()){
@@ -241,110 +246,189 @@ construct_resembla_regression(const std::string& simstring_db_path, const std::s
 
     auto resembla_regression = std::make_shared<
             ResemblaRegression<SimStringDatabase<RomajiPreprocessor>, Composition<FeatureAggregator, SVRPredictor>>>(
-                database, extractor, predictor, pm.get<int>("svr_max_candidate"), resembla_index_path);
+                database, extractor, predictor, pm.get<int>("svr_max_candidate"), resembla_index_path, pool);
     resembla_regression->append("base_similarity", resembla);
     return resembla_regression;
 }
 
+// weighted measures whose weights are stored as weight_type
+template<typename weight_type>
+std::shared_ptr<ResemblaInterface> construct_weighted_resembla(const paramset::manager& pm,
+        const measure resembla_measure, const std::string& simstring_db_path, const std::string& resembla_index_path,
+        std::shared_ptr<ThreadPool> pool, std::shared_ptr<ThreadPool> reranking_pool, size_t query_cache_size)
+{
+    check_weight_format<weight_type>(resembla_index_path);
+
+    std::shared_ptr<WordPreprocessor<string_type>> word_preprocessor;
+    std::shared_ptr<PronunciationPreprocessor> pronunciation_preprocessor;
+    std::shared_ptr<RomajiPreprocessor> romaji_preprocessor;
+
+    switch(resembla_measure){
+        case weighted_word_edit_distance:
+            word_preprocessor = std::make_shared<WordPreprocessor<string_type>>(pm.get<std::string>("wwed_mecab_options"),
+                9, Word<string_type>::used_feature_columns());
+            return construct_basic_resembla(
+                std::make_shared<SimStringDatabase<AsIsPreprocessor<string_type>>>(simstring_db_path,
+                    pm.get<int>("simstring_measure"), pm.get<double>("wwed_simstring_threshold"),
+                    std::make_shared<AsIsPreprocessor<string_type>>(), resembla_index_path, pool),
+                std::make_shared<WeightedSequenceBuilder<WordPreprocessor<string_type>, WordWeight, weight_type>>(
+                    word_preprocessor, 
+                    std::make_shared<WordWeight>(pm.get<double>("wwed_base_weight"),
+                        pm.get<double>("wwed_delete_insert_ratio"), pm.get<double>("wwed_noun_coefficient"),
+                        pm.get<double>("wwed_verb_coefficient"), pm.get<double>("wwed_adj_coefficient"))),
+                std::make_shared<WeightedEditDistance<WordMismatchCost<string_type>>>(),
+                pm.get<int>("wwed_max_reranking_num"), resembla_index_path, pool,
+                reranking_pool, pm.get<int>("resembla_min_parallel_reranking_num"), query_cache_size);
+        case weighted_pronunciation_edit_distance:
+            pronunciation_preprocessor = std::make_shared<PronunciationPreprocessor>(pm.get<std::string>("wped_mecab_options"),
+                pm.get<int>("wped_mecab_feature_pos"), pm.get<std::string>("wped_mecab_pronunciation_of_marks"),
+                pm.get<bool>("wped_ascii_without_mecab"));
+            return construct_basic_resembla(
+                std::make_shared<SimStringDatabase<PronunciationPreprocessor>>(simstring_db_path,
+                    pm.get<int>("simstring_measure"), pm.get<double>("wped_simstring_threshold"),
+                    pronunciation_preprocessor, resembla_index_path, pool),
+                std::make_shared<WeightedSequenceBuilder<PronunciationPreprocessor, LetterWeight<string_type>, weight_type>>(
+                    pronunciation_preprocessor, 
+                    std::make_shared<LetterWeight<string_type>>(pm.get<double>("wped_base_weight"),
+                        pm.get<double>("wped_delete_insert_ratio"), pm.get<std::string>("wped_letter_weight_path"))),
+                std::make_shared<WeightedEditDistance<KanaMismatchCost<string_type>>>(
+                    pm.get<std::string>("wped_mismatch_cost_path")),
+                pm.get<int>("wped_max_reranking_num"), resembla_index_path, pool,
+                reranking_pool, pm.get<int>("resembla_min_parallel_reranking_num"), query_cache_size);
+        case weighted_romaji_edit_distance:
+            romaji_preprocessor = std::make_shared<RomajiPreprocessor>(pm.get<std::string>("wred_mecab_options"),
+                pm.get<int>("wred_mecab_feature_pos"), pm.get<std::string>("wred_mecab_pronunciation_of_marks"),
+                false, pm.get<bool>("wred_ascii_without_mecab"));
+            return construct_basic_resembla(
+                std::make_shared<SimStringDatabase<RomajiPreprocessor>>(simstring_db_path,
+                    pm.get<int>("simstring_measure"), pm.get<double>("wred_simstring_threshold"),
+                    romaji_preprocessor, resembla_index_path, pool),
+                std::make_shared<WeightedSequenceBuilder<RomajiPreprocessor, RomajiWeight, weight_type>>(
+                    romaji_preprocessor, 
+                    std::make_shared<RomajiWeight>(
+                        pm.get<double>("wred_base_weight"), pm.get<double>("wred_delete_insert_ratio"),
+                        pm.get<double>("wred_uppercase_coefficient"), pm.get<double>("wred_lowercase_coefficient"),
+                        pm.get<double>("wred_vowel_coefficient"), pm.get<double>("wred_consonant_coefficient"))),
+                std::make_shared<WeightedEditDistance<RomajiMismatchCost>>(
+                    RomajiMismatchCost(pm.get<std::string>("wred_mismatch_cost_path"),
+                        pm.get<double>("wred_case_mismatch_cost"))),
+                pm.get<int>("wred_max_reranking_num"), resembla_index_path, pool,
+                reranking_pool, pm.get<int>("resembla_min_parallel_reranking_num"), query_cache_size);
+        default:
+            throw std::invalid_argument("not a weighted Resembla measure: " + std::to_string(resembla_measure));
+    }
+}
+
+std::shared_ptr<ResemblaInterface> construct_basic_resembla(const paramset::manager& pm,
+        const measure resembla_measure, std::shared_ptr<ThreadPool> pool)
+{
+    auto corpus_path = pm.get<std::string>("corpus_path");
+    auto simstring_db_path = db_path_from_resembla_measure(corpus_path, resembla_measure);
+    auto resembla_index_path = inverse_path_from_resembla_measure(corpus_path, resembla_measure);
+    auto reranking_pool = pm.get<bool>("resembla_parallel_reranking") ? pool : nullptr;
+    size_t query_cache_size = static_cast<size_t>(pm.get<int>("resembla_query_cache_size")) << 20;
+
+    switch(resembla_measure){
+        case edit_distance:
+            return construct_basic_resembla(
+                std::make_shared<SimStringDatabase<AsIsPreprocessor<string_type>>>(simstring_db_path,
+                    pm.get<int>("simstring_measure"), pm.get<double>("ed_simstring_threshold"),
+                    std::make_shared<AsIsPreprocessor<string_type>>(), resembla_index_path, pool),
+                std::make_shared<AsIsPreprocessor<string_type>>(),
+                std::make_shared<EditDistance<>>(),
+                pm.get<int>("ed_max_reranking_num"), resembla_index_path, pool,
+                reranking_pool, pm.get<int>("resembla_min_parallel_reranking_num"), query_cache_size);
+        case weighted_word_edit_distance:
+        case weighted_pronunciation_edit_distance:
+        case weighted_romaji_edit_distance:
+            switch(pm.get<int>("resembla_weight_bits")){
+                case 0:
+                    return construct_weighted_resembla<double>(pm, resembla_measure, simstring_db_path,
+                        resembla_index_path, pool, reranking_pool, query_cache_size);
+                case 16:
+                    return construct_weighted_resembla<int16_t>(pm, resembla_measure, simstring_db_path,
+                        resembla_index_path, pool, reranking_pool, query_cache_size);
+                case 32:
+                    return construct_weighted_resembla<int32_t>(pm, resembla_measure, simstring_db_path,
+                        resembla_index_path, pool, reranking_pool, query_cache_size);
+                default:
+                    throw std::invalid_argument("unsupported number of bits of weights: " +
+                        std::to_string(pm.get<int>("resembla_weight_bits")));
+            }
+        case keyword_match:
+            return construct_basic_resembla(
+                std::make_shared<SimStringDatabase<AsIsPreprocessor<string_type>>>(simstring_db_path,
+                    pm.get<int>("simstring_measure"), pm.get<double>("km_simstring_threshold"),
+                    std::make_shared<AsIsPreprocessor<string_type>>(), resembla_index_path, pool),
+                std::make_shared<KeywordMatchPreprocessor<RomajiPreprocessor>>(
+                    std::make_shared<RomajiPreprocessor>(pm.get<std::string>("index_romaji_mecab_options"),
+                        pm.get<int>("index_romaji_mecab_feature_pos"),
+                        pm.get<std::string>("index_romaji_mecab_pronunciation_of_marks"))),
+                std::make_shared<KeywordMatcher<RomajiPreprocessor>>(pm.get<double>("km_max_error_ratio")),
+                pm.get<int>("km_max_reranking_num"), resembla_index_path, pool,
+                reranking_pool, pm.get<int>("resembla_min_parallel_reranking_num"), query_cache_size);
+        default:
+            throw std::invalid_argument("not a basic Resembla measure: " + std::to_string(resembla_measure));
+    }
+}
+
+double ensemble_weight_from_resembla_measure(const paramset::manager& pm, const measure resembla_measure)
+{
+    switch(resembla_measure){
+        case edit_distance:
+            return pm.get<double>("ed_ensemble_weight");
+        case weighted_word_edit_distance:
+            return pm.get<double>("wwed_ensemble_weight");
+        case weighted_pronunciation_edit_distance:
+            return pm.get<double>("wped_ensemble_weight");
+        case weighted_romaji_edit_distance:
+            return pm.get<double>("wred_ensemble_weight");
+        case keyword_match:
+            return pm.get<double>("km_ensemble_weight");
+        default:
+            throw std::invalid_argument("not a basic Resembla measure: " + std::to_string(resembla_measure));
+    }
+}
+
 std::shared_ptr<ResemblaInterface> construct_resembla(const paramset::manager& pm)
 {
     auto corpus_path = pm.get<std::string>("corpus_path");
     auto resembla_measure_all = pm.get<std::string>("resembla_measure");
 
-    std::vector<std::pair<std::shared_ptr<ResemblaInterface>, double>> basic_resemblas;
-    std::shared_ptr<ResemblaInterface> keyword_resembla = nullptr;
+    auto num_threads = pm.get<int>("resembla_num_threads");
+    if(num_threads < 0){
+        throw std::invalid_argument("negative number of threads: " + std::to_string(num_threads));
+    }
+    auto pool = std::make_shared<ThreadPool>(num_threads);
+
+    // load indexes of all measures concurrently
+    std::vector<std::pair<measure, std::future<std::shared_ptr<ResemblaInterface>>>> futures;
     bool use_regression = false;
     for(auto resembla_measure: split_to_resembla_measures(resembla_measure_all)){
-        auto simstring_db_path = db_path_from_resembla_measure(corpus_path, resembla_measure);
-        auto resembla_index_path = inverse_path_from_resembla_measure(corpus_path, resembla_measure);
-
-        std::shared_ptr<WordPreprocessor<string_type>> word_preprocessor;
-        std::shared_ptr<PronunciationPreprocessor> pronunciation_preprocessor;
-        std::shared_ptr<RomajiPreprocessor> romaji_preprocessor;
-
-        std::shared_ptr<ResemblaInterface> new_resembla;
         switch(resembla_measure){
             case svr:
                 use_regression = true;
                 break;
-            case edit_distance:
-                basic_resemblas.push_back(std::make_pair(
-                    construct_basic_resembla(
-                        std::make_shared<SimStringDatabase<AsIsPreprocessor<string_type>>>(simstring_db_path,
-                            pm.get<int>("simstring_measure"), pm.get<double>("ed_simstring_threshold"),
-                            std::make_shared<AsIsPreprocessor<string_type>>(), resembla_index_path),
-                        std::make_shared<AsIsPreprocessor<string_type>>(),
-                        std::make_shared<EditDistance<>>(),
-                        pm.get<int>("ed_max_reranking_num"), resembla_index_path),
-                    pm.get<double>("ed_ensemble_weight")));
-                break;
-            case weighted_word_edit_distance:
-                word_preprocessor = std::make_shared<WordPreprocessor<string_type>>(pm.get<std::string>("wwed_mecab_options"));
-                basic_resemblas.push_back(std::make_pair(
-                    construct_basic_resembla(
-                        std::make_shared<SimStringDatabase<AsIsPreprocessor<string_type>>>(simstring_db_path,
-                            pm.get<int>("simstring_measure"), pm.get<double>("wwed_simstring_threshold"),
-                            std::make_shared<AsIsPreprocessor<string_type>>(), resembla_index_path),
-                        std::make_shared<WeightedSequenceBuilder<WordPreprocessor<string_type>, WordWeight>>(
-                            word_preprocessor, 
-                            std::make_shared<WordWeight>(pm.get<double>("wwed_base_weight"),
-                                pm.get<double>("wwed_delete_insert_ratio"), pm.get<double>("wwed_noun_coefficient"),
-                                pm.get<double>("wwed_verb_coefficient"), pm.get<double>("wwed_adj_coefficient"))),
-                        std::make_shared<WeightedEditDistance<WordMismatchCost<string_type>>>(),
-                        pm.get<int>("wwed_max_reranking_num"), resembla_index_path),
-                    pm.get<double>("wwed_ensemble_weight")));
-                break;
-            case weighted_pronunciation_edit_distance:
-                pronunciation_preprocessor = std::make_shared<PronunciationPreprocessor>(pm.get<std::string>("wped_mecab_options"),
-                    pm.get<int>("wped_mecab_feature_pos"), pm.get<std::string>("wped_mecab_pronunciation_of_marks"));
-                basic_resemblas.push_back(std::make_pair(
-                    construct_basic_resembla(
-                        std::make_shared<SimStringDatabase<PronunciationPreprocessor>>(simstring_db_path,
-                            pm.get<int>("simstring_measure"), pm.get<double>("wped_simstring_threshold"),
-                            pronunciation_preprocessor, resembla_index_path),
-                        std::make_shared<WeightedSequenceBuilder<PronunciationPreprocessor, LetterWeight<string_type>>>(
-                            pronunciation_preprocessor, 
-                            std::make_shared<LetterWeight<string_type>>(pm.get<double>("wped_base_weight"),
-                                pm.get<double>("wped_delete_insert_ratio"), pm.get<std::string>("wped_letter_weight_path"))),
-                        std::make_shared<WeightedEditDistance<KanaMismatchCost<string_type>>>(
-                            pm.get<std::string>("wped_mismatch_cost_path")),
-                        pm.get<int>("wped_max_reranking_num"), resembla_index_path),
-                    pm.get<double>("wped_ensemble_weight")));
-                break;
-            case weighted_romaji_edit_distance:
-                romaji_preprocessor = std::make_shared<RomajiPreprocessor>(pm.get<std::string>("wred_mecab_options"),
-                    pm.get<int>("wred_mecab_feature_pos"), pm.get<std::string>("wred_mecab_pronunciation_of_marks"));
-                basic_resemblas.push_back(std::make_pair(
-                    construct_basic_resembla(
-                        std::make_shared<SimStringDatabase<RomajiPreprocessor>>(simstring_db_path,
-                            pm.get<int>("simstring_measure"), pm.get<double>("wred_simstring_threshold"),
-                            romaji_preprocessor, resembla_index_path),
-                        std::make_shared<WeightedSequenceBuilder<RomajiPreprocessor, RomajiWeight>>(
-                            romaji_preprocessor, 
-                            std::make_shared<RomajiWeight>(
-                                pm.get<double>("wred_base_weight"), pm.get<double>("wred_delete_insert_ratio"),
-                                pm.get<double>("wred_uppercase_coefficient"), pm.get<double>("wred_lowercase_coefficient"),
-                                pm.get<double>("wred_vowel_coefficient"), pm.get<double>("wred_consonant_coefficient"))),
-                        std::make_shared<WeightedEditDistance<RomajiMismatchCost>>(
-                            RomajiMismatchCost(pm.get<std::string>("wred_mismatch_cost_path"),
-                                pm.get<double>("wred_case_mismatch_cost"))),
-                        pm.get<int>("wred_max_reranking_num"), resembla_index_path),
-                    pm.get<double>("wred_ensemble_weight")));
-                break;
-            case keyword_match:
-                keyword_resembla = construct_basic_resembla(
-                    std::make_shared<SimStringDatabase<AsIsPreprocessor<string_type>>>(simstring_db_path,
-                        pm.get<int>("simstring_measure"), pm.get<double>("km_simstring_threshold"),
-                        std::make_shared<AsIsPreprocessor<string_type>>(), resembla_index_path),
-                    std::make_shared<KeywordMatchPreprocessor<RomajiPreprocessor>>(
-                        std::make_shared<RomajiPreprocessor>(pm.get<std::string>("index_romaji_mecab_options"),
-                            pm.get<int>("index_romaji_mecab_feature_pos"),
-                            pm.get<std::string>("index_romaji_mecab_pronunciation_of_marks"))),
-                    std::make_shared<KeywordMatcher<RomajiPreprocessor>>(),
-                    pm.get<int>("km_max_reranking_num"), resembla_index_path);
-                break;
             case ensemble:
                 break;
+            default:
+                futures.push_back(std::make_pair(resembla_measure, std::async(std::launch::async,
+                    [&pm, resembla_measure, pool](){
+                        return construct_basic_resembla(pm, resembla_measure, pool);
+                    })));
+                break;
+        }
+    }
+
+    std::vector<std::pair<std::shared_ptr<ResemblaInterface>, double>> basic_resemblas;
+    std::shared_ptr<ResemblaInterface> keyword_resembla = nullptr;
+    for(auto& f: futures){
+        if(f.first == keyword_match){
+            keyword_resembla = f.second.get();
+        }
+        else{
+            basic_resemblas.push_back(std::make_pair(f.second.get(),
+                        ensemble_weight_from_resembla_measure(pm, f.first)));
         }
     }
     if(basic_resemblas.empty() && keyword_resembla == nullptr){
@@ -372,7 +456,7 @@ std::shared_ptr<ResemblaInterface> construct_resembla(const paramset::manager& p
                     pm.get<int>("simstring_measure"), pm.get<double>("wred_simstring_threshold"),
                     std::make_shared<RomajiPreprocessor>(
                         pm.get<std::string>("wred_mecab_options"), pm.get<int>("wred_mecab_feature_pos"),
-                        pm.get<std::string>("wred_mecab_pronunciation_of_marks")), resembla_index_path),
+                        pm.get<std::string>("wred_mecab_pronunciation_of_marks")), resembla_index_path, pool),
                 std::make_shared<WeightedL2Norm<>>(), pm.get<double>("ensemble_max_candidate"));
 
             for(auto p: basic_resemblas){
@@ -394,7 +478,7 @@ std::shared_ptr<ResemblaInterface> construct_resembla(const paramset::manager& p
             resembla_regression = construct_resembla_regression(
                 db_path_from_resembla_measure(corpus_path, svr),
                 inverse_path_from_resembla_measure(corpus_path, svr),
-                pm, base_resembla);
+                pm, base_resembla, pool);
         if(keyword_resembla != nullptr && base_resembla != keyword_resembla){
             resembla_regression->append(STR(keyword_match), keyword_resembla);
         }
@@ -404,6 +488,11 @@ std::shared_ptr<ResemblaInterface> construct_resembla(const paramset::manager& p
         resembla = base_resembla;
     }
 
+    if(pm.get<int>("resembla_response_cache_size") > 0){
+        resembla = std::make_shared<ResemblaCache>(resembla, pm.get<int>("resembla_response_cache_size"),
+                pm.get<double>("resembla_response_cache_ttl"));
+    }
+
     return resembla;
 }
 
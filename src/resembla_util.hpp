@@ -35,6 +35,7 @@ limitations under the License.
 
 #include "basic_resembla.hpp"
 #include "resembla_regression.hpp"
+#include "thread_pool.hpp"
 
 namespace resembla {
 
@@ -72,16 +73,27 @@ template<typename Database, typename Preprocessor, typename ScoreFunction>
 std::shared_ptr<ResemblaInterface> construct_basic_resembla(
         std::shared_ptr<Database> database, std::shared_ptr<Preprocessor> preprocess,
         std::shared_ptr<ScoreFunction> score_func,
-        size_t max_candidate, const std::string& index_path)
+        size_t max_candidate, const std::string& index_path,
+        std::shared_ptr<ThreadPool> pool = nullptr,
+        std::shared_ptr<ThreadPool> reranking_pool = nullptr, size_t min_parallel_reranking_num = 0,
+        size_t query_cache_size = 0)
 {
     return std::make_shared<BasicResembla<Database, Preprocessor, ScoreFunction>>(
             database, preprocess, score_func,
-            max_candidate, index_path);
+            max_candidate, index_path, pool, reranking_pool, min_parallel_reranking_num, query_cache_size);
 }
 
+// utility function to construct BasicResembla instance for a measure
+std::shared_ptr<ResemblaInterface> construct_basic_resembla(const paramset::manager& pm,
+        const measure resembla_measure, std::shared_ptr<ThreadPool> pool = nullptr);
+
+// utility function for getting weight of a measure in ensemble
+double ensemble_weight_from_resembla_measure(const paramset::manager& pm, const measure resembla_measure);
+
 std::shared_ptr<ResemblaRegression<SimStringDatabase<RomajiPreprocessor>, Composition<FeatureAggregator, SVRPredictor>>>
 construct_resembla_regression(const std::string& simstring_db_path, const std::string& resembla_index_path,
-        const paramset::manager& pm, const std::shared_ptr<ResemblaInterface> resembla);
+        const paramset::manager& pm, const std::shared_ptr<ResemblaInterface> resembla,
+        std::shared_ptr<ThreadPool> pool = nullptr);
 
 // utility function to construct Resembla instance
 std::shared_ptr<ResemblaInterface> construct_resembla(const paramset::manager& pm);
@@ -57,7 +57,7 @@ public:
                     id = ++max_id;
                 }
                 else{
-                    id = std::stoi(columns[id_col - 1]);
+                    id = std::stoi(cast_string<std::string>(columns[id_col - 1]));
                     max_id = std::max(id, max_id);
                 }
                 ids[text] = id;
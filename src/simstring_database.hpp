@@ -31,6 +31,7 @@ limitations under the License.
 
 #include "csv_reader.hpp"
 #include "eliminator.hpp"
+#include "thread_pool.hpp"
 
 namespace resembla {
 
@@ -42,35 +43,37 @@ public:
     using string_type = typename Indexer::output_type;
 
     SimStringDatabase(const std::string& simstring_db_path, int measure, double threshold,
-            std::shared_ptr<Indexer> index_func, const std::string& index_path):
+            std::shared_ptr<Indexer> index_func, const std::string& index_path,
+            std::shared_ptr<ThreadPool> pool = nullptr):
         measure(measure), threshold(threshold), index_func(index_func)
     {
         db.open(simstring_db_path);
 
-        for(const auto& columns: CsvReader<std::string>(index_path, 2)){
-            const auto& indexed = cast_string<simstring_string_type>(columns[0]);
-            const auto& original = cast_string<string_type>(columns[1]);
-
-            const auto& p = originals.insert(std::pair<simstring_string_type,
-                    std::vector<string_type>>(indexed, {original}));
-            if(!p.second){
-                p.first->second.push_back(original);
-            }
-        }
+        CsvReader<std::string>(index_path, 2).load(
+            [](const std::vector<std::string>& columns){
+                return std::make_pair(cast_string<simstring_string_type>(columns[0]),
+                        cast_string<string_type>(columns[1]));
+            },
+            [this](std::pair<simstring_string_type, string_type>& row){
+                const auto& p = originals.insert(std::pair<simstring_string_type,
+                        std::vector<string_type>>(row.first, {row.second}));
+                if(!p.second){
+                    p.first->second.push_back(row.second);
+                }
+            }, pool.get());
     }
 
     std::vector<string_type> search(const string_type& query, size_t max_output = 0) const
     {
-        auto search_query = (*index_func)(query);
+        auto search_query = cast_string<simstring_string_type>((*index_func)(query));
 
-        std::vector<string_type> simstring_result;
+        std::vector<simstring_string_type> simstring_result;
         {
             std::lock_guard<std::mutex> lock(mutex_simstring);
-            db.retrieve(cast_string<simstring_string_type>(search_query),
-                    measure, threshold, std::back_inserter(simstring_result));
+            db.retrieve(search_query, measure, threshold, std::back_inserter(simstring_result));
         }
         if(max_output != 0 && simstring_result.size() > max_output){
-            Eliminator<string_type> eliminate(search_query);
+            Eliminator<simstring_string_type> eliminate(search_query);
             eliminate(simstring_result, max_output);
         }
 
@@ -95,7 +98,7 @@ protected:
 
     const std::shared_ptr<Indexer> index_func;
 
-    std::unordered_map<string_type, std::vector<string_type>> originals;
+    std::unordered_map<simstring_string_type, std::vector<string_type>> originals;
 };
 
 }
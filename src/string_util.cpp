@@ -20,7 +20,9 @@ limitations under the License.
 #include "string_util.hpp"
 
 #include <stdlib.h>
+#include <stdint.h>
 
+#include <cstring>
 #include <locale>
 #include <codecvt>
 #include <iostream>
@@ -42,22 +44,306 @@ void init_locale()
     setlocale(LC_ALL, "");
 }
 
+namespace {
+
+static_assert(sizeof(wchar_t) == 4, "wchar_t is assumed to hold a code point");
+
+const uint32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+// true if 8 bytes from p are all ASCII characters
+inline bool is_ascii8(const unsigned char* p)
+{
+    uint64_t x;
+    std::memcpy(&x, p, sizeof(x));
+    return (x & 0x8080808080808080ULL) == 0;
+}
+
+inline bool is_surrogate(uint32_t code)
+{
+    return 0xD800 <= code && code <= 0xDFFF;
+}
+
+// writes a code point as one wchar_t, or one or two char16_t
+inline wchar_t* put_code_point(uint32_t code, wchar_t* out)
+{
+    *out++ = static_cast<wchar_t>(code);
+    return out;
+}
+
+inline char16_t* put_code_point(uint32_t code, char16_t* out)
+{
+    if(code < 0x10000){
+        *out++ = static_cast<char16_t>(code);
+    }
+    else{
+        code -= 0x10000;
+        *out++ = static_cast<char16_t>(0xD800 | (code >> 10));
+        *out++ = static_cast<char16_t>(0xDC00 | (code & 0x3FF));
+    }
+    return out;
+}
+
+// reads a code point from p and advances it. surrogates not paired in UTF-16 and values out of Unicode
+// are replaced with U+FFFD
+inline uint32_t get_code_point(const wchar_t*& p, const wchar_t*)
+{
+    uint32_t code = static_cast<uint32_t>(*p++);
+    return code > 0x10FFFF || is_surrogate(code) ? REPLACEMENT_CHARACTER : code;
+}
+
+inline uint32_t get_code_point(const char16_t*& p, const char16_t* end)
+{
+    uint32_t code = *p++;
+    if(!is_surrogate(code)){
+        return code;
+    }
+    else if(code < 0xDC00 && p < end && 0xDC00 <= *p && *p <= 0xDFFF){
+        return 0x10000 + ((code - 0xD800) << 10) + (*p++ - 0xDC00);
+    }
+    return REPLACEMENT_CHARACTER;
+}
+
+// number of elements decoded from valid UTF-8: bytes except continuation bytes,
+// and one more for each 4-byte sequence which becomes a surrogate pair in UTF-16.
+// continuation bytes are counted 8 bytes at once
+template<typename char_type>
+size_t decoded_length(const unsigned char* p, const unsigned char* end)
+{
+    size_t length = end - p;
+    for(; end - p >= 8 && sizeof(char_type) == 4; p += 8){
+        uint64_t x;
+        std::memcpy(&x, p, sizeof(x));
+        length -= __builtin_popcountll(x & ~(x << 1) & 0x8080808080808080ULL);
+    }
+    for(; p < end; ++p){
+        length -= (*p & 0xC0) == 0x80;
+        if(sizeof(char_type) == 2){
+            length += (*p & 0xF8) == 0xF0;
+        }
+    }
+    return length;
+}
+
+// decodes UTF-8 without depending on locales. invalid sequences are replaced with
+// U+FFFD one byte by one byte. ASCII runs are copied 8 bytes at once.
+// stops before p if out_end is reached, which happens only for invalid sequences if
+// out has room for decoded_length elements
+template<typename char_type>
+size_t decode_utf8(const unsigned char*& p, const unsigned char* end, char_type* out, char_type* out_end)
+{
+    char_type* const start = out;
+    while(p < end){
+        if(end - p >= 8 && out_end - out >= 8 && is_ascii8(p)){
+            for(int i = 0; i < 8; ++i){
+                out[i] = p[i];
+            }
+            p += 8;
+            out += 8;
+            continue;
+        }
+        else if(out == out_end){
+            break;
+        }
+
+        unsigned char c = *p;
+        if(c < 0x80){
+            *out++ = c;
+            ++p;
+            continue;
+        }
+
+        // length of sequence and minimum code point for rejecting overlong forms
+        size_t n;
+        uint32_t code, min_code;
+        if((c & 0xE0) == 0xC0){
+            n = 2;
+            code = c & 0x1F;
+            min_code = 0x80;
+        }
+        else if((c & 0xF0) == 0xE0){
+            n = 3;
+            code = c & 0x0F;
+            min_code = 0x800;
+        }
+        else if((c & 0xF8) == 0xF0){
+            n = 4;
+            code = c & 0x07;
+            min_code = 0x10000;
+        }
+        else{
+            out = put_code_point(REPLACEMENT_CHARACTER, out);
+            ++p;
+            continue;
+        }
+
+        bool valid = static_cast<size_t>(end - p) >= n;
+        for(size_t i = 1; valid && i < n; ++i){
+            if((p[i] & 0xC0) != 0x80){
+                valid = false;
+            }
+            else{
+                code = (code << 6) | (p[i] & 0x3F);
+            }
+        }
+        if(!valid || code < min_code || code > 0x10FFFF || is_surrogate(code)){
+            out = put_code_point(REPLACEMENT_CHARACTER, out);
+            ++p;
+            continue;
+        }
+        if(sizeof(char_type) == 2 && code >= 0x10000 && out_end - out < 2){
+            break;
+        }
+        out = put_code_point(code, out);
+        p += n;
+    }
+    return out - start;
+}
+
+// number of bytes of wide or UTF-16 strings encoded to UTF-8, which is exact unless they contain
+// surrogates or values out of Unicode. each element is counted separately
+template<typename char_type>
+size_t encoded_length(const char_type* p, const char_type* end)
+{
+    size_t length = 0;
+    for(; p < end; ++p){
+        uint32_t c = static_cast<uint32_t>(*p);
+        length += 1 + (c >= 0x80) + (c >= 0x800) + (c >= 0x10000);
+    }
+    return length;
+}
+
+// encodes wide or UTF-16 strings to UTF-8. out must have room for encoded_length bytes,
+// which is enough since surrogates and values out of Unicode are encoded as 3-byte U+FFFD
+template<typename char_type>
+size_t encode_utf8(const char_type* p, const char_type* end, char* out)
+{
+    char* const start = out;
+    while(p < end){
+        if(end - p >= 4 && (static_cast<uint32_t>(p[0] | p[1] | p[2] | p[3]) < 0x80)){
+            for(int i = 0; i < 4; ++i){
+                out[i] = static_cast<char>(p[i]);
+            }
+            out += 4;
+            p += 4;
+            continue;
+        }
+
+        uint32_t code = get_code_point(p, end);
+        if(code < 0x80){
+            *out++ = static_cast<char>(code);
+        }
+        else if(code < 0x800){
+            *out++ = static_cast<char>(0xC0 | (code >> 6));
+            *out++ = static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if(code < 0x10000){
+            *out++ = static_cast<char>(0xE0 | (code >> 12));
+            *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else{
+            *out++ = static_cast<char>(0xF0 | (code >> 18));
+            *out++ = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+    return out - start;
+}
+
+// strings are sized exactly, so that their capacities are not larger than needed
+template<typename string_type>
+void decode_utf8(const char* begin, const char* end, string_type& dest)
+{
+    using char_type = typename string_type::value_type;
+
+    auto p = reinterpret_cast<const unsigned char*>(begin);
+    auto e = reinterpret_cast<const unsigned char*>(end);
+    dest.resize(decoded_length<char_type>(p, e));
+    size_t length = decode_utf8(p, e, &dest[0], &dest[0] + dest.size());
+    if(p < e){
+        // invalid sequences can produce more elements than counted, but no more than one per byte
+        dest.resize(length + (e - p));
+        length += decode_utf8(p, e, &dest[length], &dest[0] + dest.size());
+    }
+    dest.resize(length);
+}
+
+template<typename string_type>
+void encode_utf8(const string_type& src, std::string& dest)
+{
+    dest.resize(encoded_length(src.data(), src.data() + src.size()));
+    if(!src.empty()){
+        dest.resize(encode_utf8(src.data(), src.data() + src.size(), &dest[0]));
+    }
+}
+
+// conversion between wide and UTF-16 strings
+template<typename src_type, typename dest_type>
+void transcode(const src_type& src, dest_type& dest)
+{
+    size_t length = 0;
+    for(auto p = src.data(), end = src.data() + src.size(); p < end;){
+        length += get_code_point(p, end) < 0x10000 || sizeof(typename dest_type::value_type) == 4 ? 1 : 2;
+    }
+    dest.resize(length);
+    auto out = &dest[0];
+    for(auto p = src.data(), end = src.data() + src.size(); p < end;){
+        out = put_code_point(get_code_point(p, end), out);
+    }
+}
+
+}
+
+void cast_string(const char* begin, const char* end, std::string& dest)
+{
+    dest.assign(begin, end);
+}
+
+void cast_string(const char* begin, const char* end, std::wstring& dest)
+{
+    decode_utf8(begin, end, dest);
+}
+
+void cast_string(const char* begin, const char* end, std::u16string& dest)
+{
+    decode_utf8(begin, end, dest);
+}
+
 template<>
 void cast_string(const std::string& src, std::wstring& dest)
 {
-    std::wstring::value_type *wcs = new std::wstring::value_type[src.length() + 1];
-    mbstowcs(wcs, src.c_str(), src.length() + 1);
-    dest = wcs;
-    delete [] wcs;
+    decode_utf8(src.data(), src.data() + src.size(), dest);
 }
 
 template<>
 void cast_string(const std::wstring& src, std::string& dest)
 {
-    std::string::value_type *mbs = new std::string::value_type[src.length() * MB_CUR_MAX + 1];
-    wcstombs(mbs, src.c_str(), src.length() * MB_CUR_MAX + 1);
-    dest = mbs;
-    delete [] mbs;
+    encode_utf8(src, dest);
+}
+
+template<>
+void cast_string(const std::string& src, std::u16string& dest)
+{
+    decode_utf8(src.data(), src.data() + src.size(), dest);
+}
+
+template<>
+void cast_string(const std::u16string& src, std::string& dest)
+{
+    encode_utf8(src, dest);
+}
+
+template<>
+void cast_string(const std::wstring& src, std::u16string& dest)
+{
+    transcode(src, dest);
+}
+
+template<>
+void cast_string(const std::u16string& src, std::wstring& dest)
+{
+    transcode(src, dest);
 }
 
 template<>
@@ -86,4 +372,16 @@ void cast_string(const icu::UnicodeString& src, std::wstring& dest)
     cast_string(tmp, dest);
 }
 
+template<>
+void cast_string(const std::u16string& src, icu::UnicodeString& dest)
+{
+    dest.setTo(reinterpret_cast<const UChar*>(src.data()), static_cast<int32_t>(src.size()));
+}
+
+template<>
+void cast_string(const icu::UnicodeString& src, std::u16string& dest)
+{
+    dest.assign(reinterpret_cast<const char16_t*>(src.getBuffer()), src.length());
+}
+
 }
@@ -26,7 +26,14 @@ limitations under the License.
 
 namespace resembla {
 
+// internal representation of texts. define RESEMBLA_UTF16 to store texts in UTF-16,
+// which halves memory for Japanese texts where wchar_t has 32 bits. in that build,
+// letters outside the BMP occupy two elements as surrogate pairs
+#ifdef RESEMBLA_UTF16
+using string_type = std::u16string;
+#else
 using string_type = std::wstring;
+#endif
 
 // common initialization procedures for using wchar_t
 void init_locale();
@@ -54,6 +61,20 @@ dest_type cast_string(const char* src)
     return cast_string<dest_type>(std::string(src));
 }
 
+// conversion of UTF-8 texts in [begin, end) without making temporary strings.
+// dest is overwritten, so that its buffer can be reused by callers
+void cast_string(const char* begin, const char* end, std::string& dest);
+void cast_string(const char* begin, const char* end, std::wstring& dest);
+void cast_string(const char* begin, const char* end, std::u16string& dest);
+
+template<typename dest_type>
+dest_type cast_string(const char* begin, const char* end)
+{
+    dest_type dest;
+    cast_string(begin, end, dest);
+    return dest;
+}
+
 template<typename char_type = char>
 constexpr char_type column_delimiter();
 // TODO: implement by a generic template function like this:
@@ -71,6 +92,12 @@ constexpr wchar_t column_delimiter()
     return L'\t';
 }
 
+template<>
+constexpr char16_t column_delimiter()
+{
+    return u'\t';
+}
+
 template<typename char_type = char>
 constexpr char_type attribute_delimiter();
 
@@ -86,6 +113,12 @@ constexpr wchar_t attribute_delimiter()
     return L'&';
 }
 
+template<>
+constexpr char16_t attribute_delimiter()
+{
+    return u'&';
+}
+
 template<typename char_type = char>
 constexpr char_type keyvalue_delimiter();
 
@@ -101,6 +134,12 @@ constexpr wchar_t keyvalue_delimiter()
     return L'=';
 }
 
+template<>
+constexpr char16_t keyvalue_delimiter()
+{
+    return u'=';
+}
+
 template<typename char_type = char>
 constexpr char_type value_delimiter();
 
@@ -116,6 +155,12 @@ constexpr wchar_t value_delimiter()
     return L',';
 }
 
+template<>
+constexpr char16_t value_delimiter()
+{
+    return u',';
+}
+
 template<typename char_type = char>
 constexpr char_type comment_prefix();
 
@@ -131,6 +176,12 @@ constexpr wchar_t comment_prefix()
     return L'#';
 }
 
+template<>
+constexpr char16_t comment_prefix()
+{
+    return u'#';
+}
+
 template<typename string_type>
 std::vector<string_type> split(const string_type& text,
         typename string_type::value_type delimiter = column_delimiter<typename string_type::value_type>(),
@@ -0,0 +1,122 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_SUFFIX_AUTOMATON_HPP
+#define RESEMBLA_SUFFIX_AUTOMATON_HPP
+
+#include <vector>
+#include <map>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+
+namespace resembla {
+
+// minimal automaton accepting all substrings of a text, which finds any pattern in O(m log σ).
+// transitions are built in maps and then packed into one sorted array
+template<typename string_type>
+class SuffixAutomaton
+{
+public:
+    using symbol_type = typename string_type::value_type;
+
+    SuffixAutomaton(const string_type& text)
+    {
+        std::vector<State> states;
+        states.reserve(2 * text.size() + 1);
+        states.push_back({0, NONE, {}});
+        size_t last = 0;
+        for(auto c: text){
+            size_t current = states.size();
+            states.push_back({states[last].length + 1, NONE, {}});
+
+            size_t p = last;
+            while(p != NONE && states[p].next.count(c) == 0){
+                states[p].next[c] = current;
+                p = states[p].link;
+            }
+            if(p == NONE){
+                states[current].link = 0;
+            }
+            else{
+                size_t q = states[p].next[c];
+                if(states[p].length + 1 == states[q].length){
+                    states[current].link = q;
+                }
+                else{
+                    size_t clone = states.size();
+                    states.push_back({states[p].length + 1, states[q].link, states[q].next});
+                    while(p != NONE){
+                        auto i = states[p].next.find(c);
+                        if(i == std::end(states[p].next) || i->second != q){
+                            break;
+                        }
+                        i->second = clone;
+                        p = states[p].link;
+                    }
+                    states[q].link = clone;
+                    states[current].link = clone;
+                }
+            }
+            last = current;
+        }
+
+        offsets.reserve(states.size() + 1);
+        for(const auto& s: states){
+            offsets.push_back(transitions.size());
+            std::copy(std::begin(s.next), std::end(s.next), std::back_inserter(transitions));
+        }
+        offsets.push_back(transitions.size());
+    }
+
+    // true if pattern is a substring of the text
+    bool contains(const string_type& pattern) const
+    {
+        size_t state = 0;
+        for(auto c: pattern){
+            auto begin = std::begin(transitions) + offsets[state];
+            auto end = std::begin(transitions) + offsets[state + 1];
+            auto i = std::lower_bound(begin, end, c,
+                [](const std::pair<symbol_type, size_t>& t, symbol_type c){
+                    return t.first < c;
+                });
+            if(i == end || i->first != c){
+                return false;
+            }
+            state = i->second;
+        }
+        return true;
+    }
+
+protected:
+    static const size_t NONE = static_cast<size_t>(-1);
+
+    struct State
+    {
+        size_t length;
+        size_t link;
+        std::map<symbol_type, size_t> next;
+    };
+
+    std::vector<size_t> offsets;
+    std::vector<std::pair<symbol_type, size_t>> transitions;
+};
+
+}
+#endif
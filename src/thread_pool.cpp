@@ -0,0 +1,77 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "thread_pool.hpp"
+
+namespace resembla {
+
+ThreadPool::ThreadPool(size_t num_threads): stopped(false)
+{
+    if(num_threads == 0){
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    for(size_t i = 0; i < num_threads; ++i){
+        workers.emplace_back([this](){
+            while(true){
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_tasks);
+                    condition_tasks.wait(lock, [this](){
+                        return stopped || !tasks.empty();
+                    });
+                    if(tasks.empty()){
+                        return;
+                    }
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_tasks);
+        stopped = true;
+    }
+    condition_tasks.notify_all();
+    for(auto& worker: workers){
+        worker.join();
+    }
+}
+
+bool ThreadPool::run_pending_task()
+{
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(mutex_tasks);
+        if(tasks.empty()){
+            return false;
+        }
+        task = std::move(tasks.front());
+        tasks.pop_front();
+    }
+    task();
+    return true;
+}
+
+}
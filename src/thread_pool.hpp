@@ -0,0 +1,139 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_THREAD_POOL_HPP
+#define RESEMBLA_THREAD_POOL_HPP
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <type_traits>
+
+namespace resembla {
+
+// fixed number of worker threads processing a shared task queue.
+// threads waiting for results help to run pending tasks, so tasks can submit and wait for other tasks
+class ThreadPool
+{
+public:
+    // use all hardware threads if num_threads is 0
+    ThreadPool(size_t num_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const
+    {
+        return workers.size();
+    }
+
+    template<typename F>
+    std::future<typename std::result_of<F()>::type> submit(F f)
+    {
+        using result_type = typename std::result_of<F()>::type;
+        auto task = std::make_shared<std::packaged_task<result_type()>>(std::move(f));
+        auto result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_tasks);
+            tasks.emplace_back([task](){
+                (*task)();
+            });
+        }
+        condition_tasks.notify_one();
+        return result;
+    }
+
+    // wait for a result while running pending tasks on the calling thread
+    template<typename T>
+    T wait(std::future<T>& result)
+    {
+        while(result.wait_for(std::chrono::seconds(0)) != std::future_status::ready){
+            if(!run_pending_task()){
+                result.wait();
+            }
+        }
+        return result.get();
+    }
+
+    // call f(begin, end) for all chunks of [0, n) on workers and the calling thread.
+    // chunks are claimed dynamically, and the chunk containing i is [i - i % chunk_size, ...)
+    template<typename F>
+    void parallel_for(size_t n, size_t chunk_size, F f)
+    {
+        if(n == 0){
+            return;
+        }
+        chunk_size = std::max(chunk_size, static_cast<size_t>(1));
+        size_t num_chunks = (n + chunk_size - 1) / chunk_size;
+
+        auto next = std::make_shared<std::atomic<size_t>>(0);
+        auto run = [next, n, chunk_size, &f](){
+            for(size_t begin = next->fetch_add(chunk_size); begin < n; begin = next->fetch_add(chunk_size)){
+                f(begin, std::min(begin + chunk_size, n));
+            }
+        };
+
+        std::vector<std::future<void>> helpers;
+        for(size_t i = 1; i < std::min(num_chunks, size() + 1); ++i){
+            helpers.push_back(submit(run));
+        }
+
+        std::exception_ptr error;
+        try{
+            run();
+        }
+        catch(...){
+            error = std::current_exception();
+            next->store(n);
+        }
+        for(auto& helper: helpers){
+            try{
+                wait(helper);
+            }
+            catch(...){
+                if(!error){
+                    error = std::current_exception();
+                }
+            }
+        }
+        if(error){
+            std::rethrow_exception(error);
+        }
+    }
+
+protected:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex_tasks;
+    std::condition_variable condition_tasks;
+    bool stopped;
+
+    bool run_pending_task();
+};
+
+}
+#endif
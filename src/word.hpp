@@ -21,14 +21,221 @@ limitations under the License.
 #define RESEMBLA_WORD_HPP
 
 #include <vector>
+#include <algorithm>
+#include <memory>
+#include <atomic>
+
+#include "intern.hpp"
+#include "string_util.hpp"
 
 namespace resembla {
 
 template<typename string_type>
-struct Word
+class WordDictionary;
+
+// word with features given by MeCab. words in a WordDictionary refer to its interned strings,
+// so that they consist of a few pointers and can be compared without looking into strings.
+// other words such as those of queries own their strings
+template<typename string_type>
+class Word
 {
-    string_type surface;
-    std::vector<string_type> feature;
+public:
+    using feature_type = std::vector<string_type>;
+
+    Word():
+        dictionary_ptr(nullptr), surface_ptr(&empty_string()), feature_ptr(&empty_feature()),
+        reading_ptr(nullptr), pronunciation_ptr(nullptr), signature_ptr(&empty_string())
+    {}
+
+    Word(const string_type& surface, const feature_type& feature):
+        local(std::make_shared<LocalStrings>(surface, feature)), dictionary_ptr(nullptr),
+        surface_ptr(&local->surface), feature_ptr(&local->feature),
+        reading_ptr(known_feature(local->feature, READING_POS)),
+        pronunciation_ptr(known_feature(local->feature, PRONUNCIATION_POS)),
+        signature_ptr(&local->signature)
+    {}
+
+    const string_type& surface() const
+    {
+        return *surface_ptr;
+    }
+
+    const feature_type& feature() const
+    {
+        return *feature_ptr;
+    }
+
+    // readings and pronunciations are nullptr if they are unknown
+    const string_type* reading() const
+    {
+        return reading_ptr;
+    }
+
+    const string_type* pronunciation() const
+    {
+        return pronunciation_ptr;
+    }
+
+    // sorted letters of the surface
+    const string_type* signature() const
+    {
+        return signature_ptr;
+    }
+
+    // dictionary which the strings belong to, or nullptr if the word owns them
+    const WordDictionary<string_type>* dictionary() const
+    {
+        return dictionary_ptr;
+    }
+
+    bool is_same_surface(const Word& w) const
+    {
+        return is_same_string(surface_ptr, w.surface_ptr, w);
+    }
+
+    // words with the same reading or pronunciation
+    bool is_homonym(const Word& w) const
+    {
+        return is_same_string(reading_ptr, w.reading_ptr, w) ||
+            is_same_string(pronunciation_ptr, w.pronunciation_ptr, w);
+    }
+
+    // columns of features referred by words and measures of words:
+    // part of speech, its subcategory, reading and pronunciation
+    static std::vector<size_t> used_feature_columns()
+    {
+        return {0, 1, READING_POS, PRONUNCIATION_POS};
+    }
+
+protected:
+    friend class WordDictionary<string_type>;
+
+    static const size_t READING_POS = 6;
+    static const size_t PRONUNCIATION_POS = 7;
+
+    struct LocalStrings
+    {
+        string_type surface;
+        feature_type feature;
+        string_type signature;
+
+        LocalStrings(const string_type& surface, const feature_type& feature):
+            surface(surface), feature(feature), signature(sorted(surface)) {}
+    };
+
+    std::shared_ptr<const LocalStrings> local;
+
+    const WordDictionary<string_type>* dictionary_ptr;
+    const string_type* surface_ptr;
+    const feature_type* feature_ptr;
+    const string_type* reading_ptr;
+    const string_type* pronunciation_ptr;
+    const string_type* signature_ptr;
+
+    // interned strings of the same dictionary are equal only if their addresses are equal
+    bool is_same_string(const string_type* a, const string_type* b, const Word& w) const
+    {
+        if(a == nullptr || b == nullptr){
+            return false;
+        }
+        return a == b || ((dictionary_ptr == nullptr || dictionary_ptr != w.dictionary_ptr) && *a == *b);
+    }
+
+    static const string_type* known_feature(const feature_type& feature, size_t pos)
+    {
+        static const string_type unknown = cast_string<string_type>("*");
+        if(pos >= feature.size() || feature[pos].empty() || feature[pos] == unknown){
+            return nullptr;
+        }
+        return &feature[pos];
+    }
+
+    static string_type sorted(string_type s)
+    {
+        std::sort(std::begin(s), std::end(s));
+        return s;
+    }
+
+    static const string_type& empty_string()
+    {
+        static const string_type empty;
+        return empty;
+    }
+
+    static const feature_type& empty_feature()
+    {
+        static const feature_type empty;
+        return empty;
+    }
+};
+
+// strings of words in a corpus. words of the corpus are interned when the index is loaded,
+// and words of queries are looked up without being added
+template<typename string_type>
+class WordDictionary
+{
+public:
+    using word_type = Word<string_type>;
+    using feature_type = typename word_type::feature_type;
+
+    WordDictionary(): dictionary_id(next_id()) {}
+    WordDictionary(const WordDictionary&) = delete;
+    WordDictionary& operator=(const WordDictionary&) = delete;
+
+    // unique among all dictionaries created in the process, even if their addresses are reused
+    size_t id() const
+    {
+        return dictionary_id;
+    }
+
+    // returns the word referring to strings in this dictionary. words can be interned concurrently
+    word_type intern(const word_type& w)
+    {
+        word_type interned;
+        interned.dictionary_ptr = this;
+        interned.surface_ptr = strings.intern(w.surface());
+        interned.feature_ptr = features.intern(w.feature());
+        interned.reading_ptr = w.reading() != nullptr ? strings.intern(*w.reading()) : nullptr;
+        interned.pronunciation_ptr = w.pronunciation() != nullptr ? strings.intern(*w.pronunciation()) : nullptr;
+        interned.signature_ptr = strings.intern(*w.signature());
+        return interned;
+    }
+
+    // returns the word referring to strings in this dictionary if all of them are known,
+    // or a word owning its strings otherwise. this must not be called while words are interned
+    word_type find(const string_type& surface, const feature_type& feature) const
+    {
+        word_type found;
+        found.dictionary_ptr = this;
+        found.surface_ptr = strings.find(surface);
+        found.feature_ptr = features.find(feature);
+        found.signature_ptr = strings.find(word_type::sorted(surface));
+        if(found.surface_ptr == nullptr || found.feature_ptr == nullptr || found.signature_ptr == nullptr){
+            return word_type(surface, feature);
+        }
+        // readings and pronunciations were interned with the feature
+        found.reading_ptr = find_feature(feature, word_type::READING_POS);
+        found.pronunciation_ptr = find_feature(feature, word_type::PRONUNCIATION_POS);
+        return found;
+    }
+
+protected:
+    const size_t dictionary_id;
+
+    InternPool<string_type> strings;
+    InternPool<feature_type, SequenceHash<feature_type>> features;
+
+    const string_type* find_feature(const feature_type& feature, size_t pos) const
+    {
+        auto f = word_type::known_feature(feature, pos);
+        return f != nullptr ? strings.find(*f) : nullptr;
+    }
+
+    static size_t next_id()
+    {
+        static std::atomic<size_t> last_id(0);
+        return ++last_id;
+    }
 };
 
 }
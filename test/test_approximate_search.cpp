@@ -0,0 +1,89 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "Catch/catch.hpp"
+
+#include "approximate_search.hpp"
+
+using namespace resembla;
+
+// minimum edit distance between pattern and substrings of text by dynamic programming
+size_t min_substring_distance(const std::string& pattern, const std::string& text)
+{
+    std::vector<size_t> D(pattern.length() + 1);
+    for(size_t i = 0; i <= pattern.length(); ++i){
+        D[i] = i;
+    }
+    size_t result = D.back();
+    for(auto c: text){
+        size_t diagonal = D[0];
+        for(size_t i = 1; i <= pattern.length(); ++i){
+            size_t current = std::min({D[i] + 1, D[i - 1] + 1, diagonal + (pattern[i - 1] == c ? 0 : 1)});
+            diagonal = D[i];
+            D[i] = current;
+        }
+        result = std::min(result, D.back());
+    }
+    return result;
+}
+
+TEST_CASE( "find approximate substrings by bit-parallel algorithm", "[approximate_search]" ) {
+    ApproximateSearch<std::string> search("banana");
+    CHECK(search.find("a banana shake", 0));
+    CHECK_FALSE(search.find("a bandana shake", 0));
+    CHECK(search.find("a bandana shake", 1));
+    CHECK_FALSE(search.find("a bnaana shake", 1));
+    CHECK(search.find("a bnaana shake", 2));
+    CHECK_FALSE(search.find("", 5));
+    CHECK(search.find("", 6));
+
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<int> letter(0, 3), length(1, 150), distance(0, 10);
+    auto random_string = [&](size_t n){
+        std::string s(n, 'a');
+        for(auto& c: s){
+            c = static_cast<char>('a' + letter(rng));
+        }
+        return s;
+    };
+    for(int k = 0; k < 200; ++k){
+        auto text = random_string(length(rng));
+        // patterns longer than 64 letters are split into blocks
+        auto pattern = random_string(length(rng) / 2 + 1);
+        auto offset = text.length() / 3;
+        if(k % 2 == 0 && pattern.length() < text.length() - offset){
+            // put a noisy copy of text into pattern, so that some of cases match
+            pattern = text.substr(offset, pattern.length());
+            pattern[pattern.length() / 2] = 'e';
+        }
+        ApproximateSearch<std::string> s(pattern);
+        auto expected = min_substring_distance(pattern, text);
+        size_t max_distance = static_cast<size_t>(distance(rng));
+        CHECK(s.find(text, max_distance) == (expected <= max_distance));
+        CHECK(s.find(text, expected));
+        if(expected > 0){
+            CHECK_FALSE(s.find(text, expected - 1));
+        }
+    }
+}
@@ -45,3 +45,29 @@ TEST_CASE( "read csv", "[file]" ) {
 
     CHECK(answer == correct);
 }
+
+TEST_CASE( "load csv in parallel", "[file]" ) {
+    init_locale();
+
+    std::string file_path = "./3x3.tsv";
+    size_t min_columns = 3;
+
+    auto parse = [](const std::vector<std::wstring>& columns){
+        return columns[0] + columns[2];
+    };
+
+    std::vector<std::wstring> correct;
+    CsvReader<std::wstring>(file_path, min_columns).load(parse, [&correct](std::wstring& row){
+        correct.push_back(row);
+    });
+    CHECK(correct == std::vector<std::wstring>({L"v00v02", L"v10v12", L"v20v22"}));
+
+    ThreadPool pool(4);
+    for(size_t chunk_size = 1; chunk_size <= 4; ++chunk_size){
+        std::vector<std::wstring> answer;
+        CsvReader<std::wstring>(file_path, min_columns).load(parse, [&answer](std::wstring& row){
+            answer.push_back(row);
+        }, &pool, chunk_size);
+        CHECK(answer == correct);
+    }
+}
@@ -18,6 +18,8 @@ limitations under the License.
 */
 
 #include <string>
+#include <vector>
+#include <random>
 #include <iostream>
 
 #include "Catch/catch.hpp"
@@ -40,3 +42,81 @@ TEST_CASE( "compute edit distance", "[measure]" ) {
     CHECK(ed(std::string("ad"), std::string("abcd")) == Approx(4.0 / 6));
     CHECK(ed(std::string("abce"), std::string("bxde")) == Approx(4.0 / 8));
 }
+
+TEST_CASE( "compute edit distance by bit-parallel algorithm", "[measure]" ) {
+    EditDistance<> ed;
+    CHECK(ed.prepare(std::string(""))(std::string(""), std::string("")) == Approx(1.0));
+    CHECK(ed.prepare(std::string(""))(std::string(""), std::string("a")) == Approx(0.0));
+    CHECK(ed.prepare(std::string("a"))(std::string("a"), std::string("")) == Approx(0.0));
+    CHECK(ed.prepare(std::string("abce"))(std::string("abce"), std::string("bxde")) == Approx(4.0 / 8));
+
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<int> letter(0, 3);
+    auto random_string = [&](size_t length){
+        std::string s(length, 'a');
+        for(auto& c: s){
+            c = static_cast<char>('a' + letter(rng));
+        }
+        return s;
+    };
+    for(size_t a_length: {1, 10, 63, 64, 65, 130, 200}){
+        auto a = random_string(a_length);
+        auto prepared = ed.prepare(a);
+        for(size_t b_length: {1, 5, 64, 100, 300}){
+            for(int k = 0; k < 5; ++k){
+                auto b = random_string(b_length);
+                CHECK(prepared(a, b) == Approx(ed(a, b)));
+            }
+        }
+    }
+}
+
+// costs between different letters are 0.5 or 1
+struct HalfCost
+{
+    double operator()(char a, char b) const
+    {
+        return a == b ? 0.0 : (a ^ b) & 1 ? 1.0 : 0.5;
+    }
+};
+
+TEST_CASE( "compute edit distances in batches", "[measure]" ) {
+    EditDistance<HalfCost> ed;
+    using Batch = BatchEditDistance<EditDistance<HalfCost>, UnitWeightAccess, std::string, FloatLane>;
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> letter(0, 5), length(0, 20);
+    auto random_string = [&](){
+        std::string s(length(rng), 'a');
+        for(auto& c: s){
+            c = static_cast<char>('a' + letter(rng));
+        }
+        return s;
+    };
+    for(int k = 0; k < 30; ++k){
+        auto a = random_string();
+        Batch batch(ed, a);
+        std::vector<std::string> b;
+        std::vector<const std::string*> group;
+        for(size_t l = 0; l < Batch::LANES - k % 3; ++l){
+            b.push_back(random_string());
+        }
+        for(const auto& s: b){
+            group.push_back(&s);
+        }
+        for(double min_score: {0.0, 0.5}){
+            std::vector<double> scores(b.size());
+            batch(&group[0], b.size(), min_score, &scores[0]);
+            for(size_t l = 0; l < b.size(); ++l){
+                auto correct = ed(a, b[l]);
+                if(correct >= min_score){
+                    CHECK(std::abs(scores[l] - correct) < 1e-5);
+                }
+                else{
+                    CHECK(scores[l] < min_score + 1e-5);
+                    CHECK(scores[l] >= correct - 1e-5);
+                }
+            }
+        }
+    }
+}
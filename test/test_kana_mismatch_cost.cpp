@@ -127,3 +127,16 @@ TEST_CASE( "check kana_mismatch_cost when input letter is not a kana", "[languag
     test_kana_mismatch_cost(L'ア', L'宛', "../example/conf/kana_mismatch_cost.tsv", 1.0);
     test_kana_mismatch_cost(L'あ', L'宛', "../example/conf/kana_mismatch_cost.tsv", 1.0);
 }
+
+TEST_CASE( "check kana_mismatch_cost of letters not in the file", "[language]" ) {
+    test_kana_mismatch_cost(L'ア', L'宛', "../example/conf/kana_mismatch_cost.tsv", 1.0);
+    test_kana_mismatch_cost(L'a', L'ア', "../example/conf/kana_mismatch_cost.tsv", 1.0);
+    test_kana_mismatch_cost(L'ア', L'ァ', "", 1.0);
+    test_kana_mismatch_cost(L'ア', L'ア', "", 0.0);
+}
+
+TEST_CASE( "check minimum of kana_mismatch_cost", "[language]" ) {
+    init_locale();
+    CHECK(KanaMismatchCost<string_type>("../example/conf/kana_mismatch_cost.tsv").min_mismatch_cost() == Approx(0.1));
+    CHECK(KanaMismatchCost<string_type>("").min_mismatch_cost() == Approx(1.0));
+}
@@ -0,0 +1,72 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+
+#include "Catch/catch.hpp"
+
+#include "measure/asis_preprocessor.hpp"
+#include "measure/keyword_matcher.hpp"
+
+using namespace resembla;
+
+TEST_CASE( "match keywords with prepared target", "[measure]" ) {
+    using Matcher = KeywordMatcher<AsIsPreprocessor<string_type>>;
+    Matcher::input_type target = {L"りんごとバナナのジュース", {}};
+    Matcher::input_type reference0 = {L"バナナジュース", {L"バナナ", L"ジュース"}};
+    Matcher::input_type reference1 = {L"りんごジャム", {L"りんご", L"ジャム", L"パン"}};
+    Matcher::input_type reference2 = {L"みかん", {}};
+
+    Matcher match;
+    auto prepared = match.prepare(target);
+    CHECK(match(target, reference0) == Approx(1.0));
+    CHECK(match(target, reference1) == Approx(-1.0 / 3));
+    CHECK(match(target, reference2) == Approx(0.0));
+    for(const auto& reference: {reference0, reference1, reference2}){
+        CHECK(prepared(target, reference) == Approx(match(target, reference)));
+    }
+}
+
+TEST_CASE( "match keywords approximately", "[measure]" ) {
+    using Matcher = KeywordMatcher<AsIsPreprocessor<string_type>>;
+    Matcher::input_type target = {L"りんごとバナナのジュース", {}};
+    Matcher::input_type reference0 = {L"バナナジユース", {L"バナナジユース"}};
+    Matcher::input_type reference1 = {L"りんごジャム", {L"りんごとバネ", L"ジャム"}};
+
+    Matcher exact_match;
+    CHECK(exact_match(target, reference0) == Approx(-1.0));
+    CHECK(exact_match(target, reference1) == Approx(-1.0));
+
+    // 1 error is allowed for keywords of 7 letters
+    Matcher match(0.15);
+    auto prepared = match.prepare(target);
+    CHECK(match(target, reference0) == Approx(-1.0));
+    CHECK(match(target, reference1) == Approx(-1.0));
+
+    // 2 errors for 7 letters, 1 error for 6 letters and none for 3 letters
+
+    Matcher loose_match(0.3);
+    auto loose_prepared = loose_match.prepare(target);
+    CHECK(loose_match(target, reference0) == Approx(1.0));
+    CHECK(loose_match(target, reference1) == Approx(0.0));
+    for(const auto& reference: {reference0, reference1}){
+        CHECK(prepared(target, reference) == Approx(match(target, reference)));
+        CHECK(loose_prepared(target, reference) == Approx(loose_match(target, reference)));
+    }
+}
@@ -17,6 +17,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <vector>
+
 #include "Catch/catch.hpp"
 
 #include "string_util.hpp"
@@ -52,3 +54,24 @@ TEST_CASE( "check letter_weight with kana letters", "[language]" ) {
     CHECK(kana_weight2(L'ア', true) == Approx(0.714));
     CHECK(kana_weight2(L'イ', false) == Approx(0.42));
 }
+
+TEST_CASE( "check letter_weight of whole sequences", "[language]" ) {
+    init_locale();
+
+    LetterWeight<string_type> kana_weight(0.6, 1.7, "../example/conf/kana_weight.tsv");
+    string_type s = L"アイゥーカ御.";
+    for(bool is_original: {false, true}){
+        std::vector<double> weights;
+        kana_weight.weigh(s, is_original, [&weights](double w){
+            weights.push_back(w);
+        });
+        REQUIRE(weights.size() == s.size());
+        for(size_t i = 0; i < s.size(); ++i){
+            CHECK(weights[i] == kana_weight(s[i], is_original));
+        }
+    }
+
+    LetterWeight<string_type> uniform_weight(0.6, 1.7, "");
+    CHECK(uniform_weight(L'ア') == Approx(0.6));
+    CHECK(uniform_weight(L'ア', true) == Approx(1.02));
+}
@@ -0,0 +1,103 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <thread>
+
+#include "Catch/catch.hpp"
+
+#include "lru_cache.hpp"
+#include "memory_usage.hpp"
+
+using namespace resembla;
+
+TEST_CASE( "evict least recently used entries", "[cache]" ) {
+    LruCache<std::string, int> cache(3, 1);
+    int value = 0;
+    CHECK(!cache.get("a", value));
+
+    cache.put("a", 1, 1);
+    cache.put("b", 2, 1);
+    cache.put("c", 3, 1);
+    CHECK(cache.get("a", value));
+    CHECK(value == 1);
+
+    // b is the least recently used entry
+    cache.put("d", 4, 1);
+    CHECK(!cache.get("b", value));
+    CHECK(cache.get("c", value));
+    CHECK(cache.get("d", value));
+
+    // entries with large costs are evicted together
+    cache.put("e", 5, 2);
+    CHECK(!cache.get("a", value));
+    CHECK(!cache.get("c", value));
+    CHECK(cache.get("e", value));
+    CHECK(value == 5);
+
+    // too large entries are never stored
+    cache.put("f", 6, 4);
+    CHECK(!cache.get("f", value));
+
+    CHECK(cache.hits() == 4);
+    CHECK(cache.misses() == 5);
+    CHECK(cache.hit_ratio() == Approx(4.0 / 9));
+
+    cache.clear();
+    CHECK(!cache.get("e", value));
+}
+
+TEST_CASE( "access LRU cache from multiple threads", "[cache]" ) {
+    LruCache<int, int> cache(100);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t){
+        threads.emplace_back([&cache, t](){
+            for(int i = 0; i < 10000; ++i){
+                int key = (i * 7 + t) % 200, value;
+                if(cache.get(key, value)){
+                    CHECK(value == key * 2);
+                }
+                else{
+                    cache.put(key, key * 2, 1);
+                }
+            }
+        });
+    }
+    for(auto& t: threads){
+        t.join();
+    }
+    CHECK(cache.hits() + cache.misses() == 40000);
+}
+
+TEST_CASE( "estimate memory usage", "[cache]" ) {
+    std::wstring s(100, L'a');
+    CHECK(memory_usage(s) >= 100 * sizeof(wchar_t));
+
+    std::vector<std::wstring> v(10, s);
+    CHECK(memory_usage(v) >= 10 * memory_usage(s));
+
+    struct WeightedToken
+    {
+        std::wstring token;
+        double weight;
+    };
+    std::vector<WeightedToken> w(10, {s, 1.0});
+    CHECK(memory_usage(w) >= 10 * memory_usage(s));
+}
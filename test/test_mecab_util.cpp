@@ -24,8 +24,11 @@ limitations under the License.
 #include <string>
 #include <unordered_map>
 #include <set>
+#include <vector>
 #include <memory>
 #include <stdexcept>
+#include <numeric>
+#include <thread>
 
 #include "mecab_util.hpp"
 
@@ -43,3 +46,121 @@ TEST_CASE( "validate MeCab options", "[MeCab]" ) {
     REQUIRE_THROWS(validate_mecab_options("-d"));
     REQUIRE_THROWS(validate_mecab_options("-Odump -d"));
 }
+
+TEST_CASE( "parse texts by MeCab on multiple threads", "[MeCab]" ) {
+    MeCabTagger tagger;
+    std::vector<std::string> texts = {"すもももももももものうち", "東京特許許可局", "隣の客はよく柿食う客だ"};
+    auto parse = [&tagger](const std::string& text){
+        std::vector<std::string> surfaces;
+        tagger.parse(text, [&surfaces](const MeCabNode& node){
+            surfaces.push_back(std::string(node.surface, node.surface + node.length));
+        });
+        return surfaces;
+    };
+
+    std::vector<std::vector<std::string>> expected;
+    for(const auto& text: texts){
+        expected.push_back(parse(text));
+        CHECK(std::accumulate(expected.back().begin(), expected.back().end(), std::string()) == text);
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(4, 0);
+    for(size_t t = 0; t < mismatches.size(); ++t){
+        threads.emplace_back([&, t](){
+            for(size_t i = 0; i < 300; ++i){
+                if(parse(texts[(i + t) % texts.size()]) != expected[(i + t) % texts.size()]){
+                    ++mismatches[t];
+                }
+            }
+        });
+    }
+    for(auto& thread: threads){
+        thread.join();
+    }
+    for(auto m: mismatches){
+        CHECK(m == 0);
+    }
+}
+
+TEST_CASE( "share analyses of MeCab in a scope", "[MeCab]" ) {
+    MeCabTagger tagger0, tagger1;
+    std::string text = "すもももももももものうち";
+    auto parse = [&text](const MeCabTagger& tagger){
+        std::vector<std::pair<std::string, std::string>> morphemes;
+        tagger.parse(text, [&morphemes](const MeCabNode& node){
+            morphemes.emplace_back(std::string(node.surface, node.surface + node.length), node.feature);
+        });
+        return morphemes;
+    };
+    auto expected = parse(tagger0);
+    REQUIRE(!expected.empty());
+
+    CHECK(MeCabAnalysisScope::find("", text) == nullptr);
+    {
+        MeCabAnalysisScope scope;
+        CHECK(parse(tagger0) == expected);
+        auto analysis = MeCabAnalysisScope::find("", text);
+        REQUIRE(analysis != nullptr);
+        CHECK(analysis->size() == expected.size());
+
+        {
+            MeCabAnalysisScope inner;
+            CHECK(MeCabAnalysisScope::find("", text) == analysis);
+            CHECK(parse(tagger1) == expected);
+        }
+        CHECK(MeCabAnalysisScope::find("", text) == analysis);
+
+        // other threads do not see analyses of this thread
+        bool found = true;
+        std::thread([&text, &found](){
+            found = MeCabAnalysisScope::find("", text) != nullptr;
+        }).join();
+        CHECK_FALSE(found);
+    }
+    CHECK(MeCabAnalysisScope::find("", text) == nullptr);
+}
+
+TEST_CASE( "share MeCab models of same options", "[MeCab]" ) {
+    auto model0 = shared_mecab_model("");
+    auto model1 = shared_mecab_model("");
+    auto model2 = shared_mecab_model("-Owakati");
+    CHECK(model0 != nullptr);
+    CHECK(model0 == model1);
+    CHECK(model0 != model2);
+
+    MeCabTagger tagger;
+    CHECK(shared_mecab_model("") == model0);
+    CHECK(model0.use_count() > 2);
+
+    std::weak_ptr<MeCab::Model> released = model2;
+    model2.reset();
+    CHECK(released.expired());
+
+    REQUIRE_THROWS(shared_mecab_model("-d /invalid_dict"));
+}
+
+TEST_CASE( "extract columns of MeCab features", "[MeCab]" ) {
+    init_locale();
+    const char* feature = "名詞,,固有名詞,地域,一般,*,*,トウキョウ,トーキョー";
+
+    MeCabFeatureColumns<std::wstring> all;
+    CHECK(all(feature) == (std::vector<std::wstring>{L"名詞", L"固有名詞", L"地域", L"一般", L"*", L"*", L"トウキョウ", L"トーキョー"}));
+    CHECK(all("") == std::vector<std::wstring>());
+
+    MeCabFeatureColumns<std::wstring> padded({}, 10);
+    CHECK(padded(feature).size() == 10);
+    CHECK(padded(feature)[7] == L"トーキョー");
+    CHECK(padded(feature)[9] == L"");
+
+    MeCabFeatureColumns<std::wstring> some({7, 0, 0}, 9);
+    CHECK(some(feature) == (std::vector<std::wstring>{L"名詞", L"", L"", L"", L"", L"", L"", L"トーキョー", L""}));
+
+    MeCabFeatureColumns<std::wstring> missing({20});
+    CHECK(missing(feature) == std::vector<std::wstring>());
+
+    CHECK(MeCabFeatureColumns<std::wstring>::column(feature, 0) == L"名詞");
+    CHECK(MeCabFeatureColumns<std::wstring>::column(feature, 6) == L"トウキョウ");
+    CHECK(MeCabFeatureColumns<std::wstring>::column(feature, 8) == L"");
+    CHECK(MeCabFeatureColumns<std::wstring>::column("a,b,", 1) == L"b");
+}
@@ -148,3 +148,33 @@ TEST_CASE( "parse a sentence including marks to text", "[language]" ) {
     std::wstring correct = L"アッ!!キョーナンノヒダッケ？オシエテ。";
     test_pronunciation_preprocessor(input, correct);
 }
+
+TEST_CASE( "convert kana and ASCII texts to pronunciation sequences without MeCab", "[language]" ) {
+    init_locale();
+    PronunciationPreprocessor preprocess(
+        PRONUNCIATION_SEQUENCE_PARSER_MECAB_OPTIONS,
+        PRONUNCIATION_SEQUENCE_PARSER_MECAB_FUTURE_POS,
+        PRONUNCIATION_SEQUENCE_PARSER_MECAB_PRONUNCIATION_OF_MARKS, true);
+    auto copied = preprocess;
+
+    CHECK(preprocess(L"すもゝヰヱゟ") == L"スモヽイエヨリ");
+    CHECK(copied(L"ABC-123 xyz") == L"ABC-123xyz");
+    CHECK(preprocess(L"abc\tシケン", true) == L"abc");
+    CHECK(preprocess(L"しけん\tabc", true) == L"シケン");
+    CHECK(preprocess.kana_count() == 2);
+    CHECK(preprocess.ascii_count() == 2);
+    CHECK(preprocess.mecab_count() == 0);
+
+    // long vowel marks are left to MeCab
+    preprocess(L"ラーメン");
+    CHECK(preprocess.kana_count() == 2);
+    CHECK(preprocess.mecab_count() == 1);
+
+    PronunciationPreprocessor without_ascii(
+        PRONUNCIATION_SEQUENCE_PARSER_MECAB_OPTIONS,
+        PRONUNCIATION_SEQUENCE_PARSER_MECAB_FUTURE_POS,
+        PRONUNCIATION_SEQUENCE_PARSER_MECAB_PRONUNCIATION_OF_MARKS);
+    without_ascii(L"ABC");
+    CHECK(without_ascii.ascii_count() == 0);
+    CHECK(without_ascii.mecab_count() == 1);
+}
@@ -0,0 +1,237 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "Catch/catch.hpp"
+
+#include "reranker.hpp"
+#include "measure/edit_distance.hpp"
+#include "measure/weighted_edit_distance.hpp"
+
+using namespace resembla;
+
+struct DummyScore
+{
+    double operator()(int a, int b) const
+    {
+        return 1.0 / (1 + std::abs(a - b) / 10);
+    }
+};
+
+// hides the bit-parallel computation of EditDistance
+struct EditDistanceScore
+{
+    double operator()(const std::string& a, const std::string& b) const
+    {
+        return EditDistance<>()(a, b);
+    }
+};
+
+// same as FixedCost, but EditDistance doesn't use bit-parallel computation with it
+struct UnitCost
+{
+    double operator()(char a, char b) const
+    {
+        return a == b ? 0.0 : 1.0;
+    }
+};
+
+TEST_CASE( "rerank candidates", "[reranker]" ) {
+    std::vector<std::pair<std::string, int>> candidates;
+    for(int i = 0; i < 1000; ++i){
+        candidates.push_back(std::make_pair(std::to_string(i), (i * 37) % 1000));
+    }
+    auto target = std::make_pair(std::string("500"), 500);
+
+    Reranker<std::string> sequential;
+    auto all = sequential.rerank(target, std::begin(candidates), std::end(candidates), DummyScore());
+    REQUIRE(all.size() == candidates.size());
+    for(size_t i = 1; i < all.size(); ++i){
+        CHECK(all[i - 1].second >= all[i].second);
+        if(all[i - 1].second == all[i].second){
+            // ties are ordered by position
+            CHECK(std::stoi(all[i - 1].first) < std::stoi(all[i].first));
+        }
+    }
+
+    Reranker<std::string> parallel(std::make_shared<ThreadPool>(3), 100);
+    for(size_t max_output: {0, 1, 5, 15, 100, 2000}){
+        for(double threshold: {0.0, 0.05, 0.5}){
+            auto correct = sequential.rerank(target, std::begin(candidates), std::end(candidates),
+                    DummyScore(), threshold, max_output);
+            auto answer = parallel.rerank(target, std::begin(candidates), std::end(candidates),
+                    DummyScore(), threshold, max_output);
+            CHECK(answer == correct);
+            if(max_output != 0){
+                CHECK(correct.size() <= max_output);
+            }
+            for(const auto& r: correct){
+                CHECK(r.second >= threshold);
+            }
+        }
+    }
+}
+
+TEST_CASE( "rerank candidates given as pointers", "[reranker]" ) {
+    std::vector<std::pair<std::string, int>> candidates;
+    for(int i = 0; i < 100; ++i){
+        candidates.push_back(std::make_pair(std::to_string(i), (i * 37) % 100));
+    }
+    std::vector<std::pair<const std::string*, const int*>> views;
+    for(const auto& c: candidates){
+        views.push_back(std::make_pair(&c.first, &c.second));
+    }
+    std::string target_text = "50";
+    int target_data = 50;
+
+    auto correct = Reranker<std::string>().rerank(std::make_pair(target_text, target_data),
+            std::begin(candidates), std::end(candidates), DummyScore(), 0.1, 10);
+    auto answer = Reranker<const std::string*>().rerank(std::make_pair(&target_text, &target_data),
+            std::begin(views), std::end(views), DummyScore(), 0.1, 10);
+    REQUIRE(answer.size() == correct.size());
+    for(size_t i = 0; i < answer.size(); ++i){
+        CHECK(*answer[i].first == correct[i].first);
+        CHECK(answer[i].second == correct[i].second);
+    }
+}
+
+TEST_CASE( "rerank candidates with prepared target", "[reranker]" ) {
+    std::vector<std::pair<std::string, std::string>> candidates;
+    std::string letters = "abcd";
+    for(int i = 0; i < 500; ++i){
+        std::string s;
+        for(int j = 0; j < 3 + i % 7; ++j){
+            s += letters[(i * 7 + j * j * 3) % letters.size()];
+        }
+        candidates.push_back(std::make_pair(std::to_string(i), s));
+    }
+    auto target = std::make_pair(std::string("target"), std::string("abcdab"));
+
+    Reranker<std::string> sequential;
+    Reranker<std::string> parallel(std::make_shared<ThreadPool>(3), 100);
+    for(size_t max_output: {0, 1, 5, 20, 1000}){
+        for(double threshold: {0.0, 0.3, 0.6}){
+            auto correct = sequential.rerank(target, std::begin(candidates), std::end(candidates),
+                    EditDistanceScore(), threshold, max_output);
+            CHECK(sequential.rerank(target, std::begin(candidates), std::end(candidates),
+                    EditDistance<UnitCost>(), threshold, max_output) == correct);
+            CHECK(parallel.rerank(target, std::begin(candidates), std::end(candidates),
+                    EditDistance<UnitCost>(), threshold, max_output) == correct);
+            CHECK(sequential.rerank(target, std::begin(candidates), std::end(candidates),
+                    EditDistance<>(), threshold, max_output) == correct);
+            CHECK(parallel.rerank(target, std::begin(candidates), std::end(candidates),
+                    EditDistance<>(), threshold, max_output) == correct);
+        }
+    }
+}
+
+struct WeightedChar
+{
+    char token;
+    double weight;
+};
+
+struct QuantizedChar
+{
+    char token;
+    int16_t weight;
+};
+
+// hides the histogram filter of WeightedEditDistance
+struct WeightedEditDistanceScore
+{
+    double operator()(const std::vector<WeightedChar>& a, const std::vector<WeightedChar>& b) const
+    {
+        return WeightedEditDistance<>().columnwise(a, b);
+    }
+};
+
+TEST_CASE( "rerank candidates pruned by upper bounds", "[reranker]" ) {
+    std::vector<std::pair<std::string, std::vector<WeightedChar>>> candidates;
+    std::string letters = "abcdefgh";
+    for(int i = 0; i < 500; ++i){
+        std::vector<WeightedChar> s;
+        for(int j = 0; j < 3 + i % 7; ++j){
+            s.push_back({letters[(i * 7 + j * j * 3) % letters.size()], 1.0 + (i + j) % 3 * 0.5});
+        }
+        candidates.push_back(std::make_pair(std::to_string(i), s));
+    }
+    std::vector<WeightedChar> query = {{'a', 1.0}, {'b', 1.5}, {'c', 1.0}, {'d', 2.0}, {'a', 1.0}, {'b', 1.0}};
+    auto target = std::make_pair(std::string("target"), query);
+
+    Reranker<std::string> sequential;
+    Reranker<std::string> parallel(std::make_shared<ThreadPool>(3), 100);
+    for(size_t max_output: {0, 1, 5, 20, 1000}){
+        for(double threshold: {0.0, 0.3, 0.6}){
+            auto correct = sequential.rerank(target, std::begin(candidates), std::end(candidates),
+                    WeightedEditDistanceScore(), threshold, max_output);
+            auto sequential_result = sequential.rerank(target, std::begin(candidates), std::end(candidates),
+                    WeightedEditDistance<>(), threshold, max_output);
+            auto parallel_result = parallel.rerank(target, std::begin(candidates), std::end(candidates),
+                    WeightedEditDistance<>(), threshold, max_output);
+            REQUIRE(sequential_result.size() == correct.size());
+            REQUIRE(parallel_result.size() == correct.size());
+            for(size_t i = 0; i < correct.size(); ++i){
+                CHECK(sequential_result[i].first == correct[i].first);
+                CHECK(sequential_result[i].second == Approx(correct[i].second));
+                CHECK(parallel_result[i].first == correct[i].first);
+                CHECK(parallel_result[i].second == Approx(correct[i].second));
+            }
+        }
+    }
+}
+
+// hides the batch scoring of WeightedEditDistance
+struct QuantizedEditDistanceScore
+{
+    double operator()(const std::vector<QuantizedChar>& a, const std::vector<QuantizedChar>& b) const
+    {
+        return WeightedEditDistance<>().columnwise(a, b);
+    }
+};
+
+TEST_CASE( "rerank candidates in batches", "[reranker]" ) {
+    std::vector<std::pair<std::string, std::vector<QuantizedChar>>> candidates;
+    std::string letters = "abcdefgh";
+    for(int i = 0; i < 500; ++i){
+        std::vector<QuantizedChar> s;
+        for(int j = 0; j < 3 + i % 11; ++j){
+            s.push_back({letters[(i * 7 + j * j * 3) % letters.size()], static_cast<int16_t>(128 + (i + j) % 3 * 64)});
+        }
+        candidates.push_back(std::make_pair(std::to_string(i), s));
+    }
+    std::vector<QuantizedChar> query = {{'a', 128}, {'b', 192}, {'c', 128}, {'d', 256}, {'a', 128}, {'b', 128}};
+    auto target = std::make_pair(std::string("target"), query);
+
+    Reranker<std::string> sequential;
+    Reranker<std::string> parallel(std::make_shared<ThreadPool>(3), 100);
+    for(size_t max_output: {0, 1, 5, 20, 1000}){
+        for(double threshold: {0.0, 0.3, 0.6}){
+            auto correct = sequential.rerank(target, std::begin(candidates), std::end(candidates),
+                    QuantizedEditDistanceScore(), threshold, max_output);
+            CHECK(sequential.rerank(target, std::begin(candidates), std::end(candidates),
+                    WeightedEditDistance<>(), threshold, max_output) == correct);
+            CHECK(parallel.rerank(target, std::begin(candidates), std::end(candidates),
+                    WeightedEditDistance<>(), threshold, max_output) == correct);
+        }
+    }
+}
@@ -0,0 +1,123 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include "Catch/catch.hpp"
+
+#include "resembla_cache.hpp"
+
+using namespace resembla;
+
+class CountingResembla: public ResemblaInterface
+{
+public:
+    mutable std::atomic<int> count;
+
+    CountingResembla(int wait_ms = 0): count(0), wait_ms(wait_ms) {}
+
+    std::vector<output_type> find(const string_type& query,
+            double threshold = 0.0, size_t max_response = 0) const
+    {
+        ++count;
+        std::this_thread::sleep_for(std::chrono::milliseconds(wait_ms));
+        return {{query, threshold}, {query + L"!", static_cast<double>(max_response)}};
+    }
+
+    std::vector<output_type> eval(const string_type&, const std::vector<string_type>&,
+            double = 0.0, size_t = 0) const
+    {
+        ++count;
+        return {};
+    }
+
+protected:
+    int wait_ms;
+};
+
+TEST_CASE( "cache responses", "[cache]" ) {
+    auto counter = std::make_shared<CountingResembla>();
+    ResemblaCache cache(counter, 2);
+
+    auto r = cache.find(L"a", 0.5, 10);
+    REQUIRE(r.size() == 2);
+    CHECK(r[0].text == L"a");
+    CHECK(r[0].score == Approx(0.5));
+    CHECK(r[1].score == Approx(10));
+    CHECK(counter->count == 1);
+
+    cache.find(L"a", 0.5, 10);
+    CHECK(counter->count == 1);
+    CHECK(cache.hits() == 1);
+
+    // different parameters are different keys
+    cache.find(L"a", 0.5, 5);
+    cache.find(L"a", 0.2, 10);
+    CHECK(counter->count == 3);
+
+    // eval is never cached
+    cache.eval(L"a", {L"b"});
+    cache.eval(L"a", {L"b"});
+    CHECK(counter->count == 5);
+
+    // entries are discarded by clear
+    cache.find(L"a", 0.2, 10);
+    CHECK(counter->count == 5);
+    cache.clear();
+    cache.find(L"a", 0.2, 10);
+    CHECK(counter->count == 6);
+}
+
+TEST_CASE( "expire cached responses", "[cache]" ) {
+    auto counter = std::make_shared<CountingResembla>();
+    ResemblaCache cache(counter, 10, 0.05);
+
+    cache.find(L"a");
+    cache.find(L"a");
+    CHECK(counter->count == 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    cache.find(L"a");
+    CHECK(counter->count == 2);
+}
+
+TEST_CASE( "deduplicate concurrent requests", "[cache]" ) {
+    auto counter = std::make_shared<CountingResembla>(200);
+    ResemblaCache cache(counter, 10);
+
+    std::vector<std::thread> threads;
+    std::vector<std::vector<ResemblaInterface::output_type>> results(4);
+    for(size_t i = 0; i < results.size(); ++i){
+        threads.emplace_back([&cache, &results, i](){
+            results[i] = cache.find(L"a");
+        });
+    }
+    for(auto& t: threads){
+        t.join();
+    }
+    CHECK(counter->count == 1);
+    for(const auto& r: results){
+        REQUIRE(r.size() == 2);
+        CHECK(r[0].text == L"a");
+    }
+}
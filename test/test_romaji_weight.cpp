@@ -18,6 +18,7 @@ limitations under the License.
 */
 
 #include <iostream>
+#include <vector>
 
 #include "Catch/catch.hpp"
 
@@ -103,3 +104,19 @@ TEST_CASE( "check romaji_weight with complex weight settings", "[language]" ) {
     test_romaji_weight(L'あ', 2L, 3L, 5L, 7L, 11L, 13L, false, 2L);
     test_romaji_weight(L'宛', 2L, 3L, 5L, 7L, 11L, 13L, true, 6L);
 }
+
+TEST_CASE( "check romaji_weight of whole sequences", "[language]" ) {
+    init_locale();
+    RomajiWeight weight(1L, 1.2L, 1L, 0.5L, 1L, 0.8L);
+    string_type s = L"AiKz0-あ宛";
+    for(bool is_original: {false, true}){
+        std::vector<double> weights;
+        weight.weigh(s, is_original, [&weights](double w){
+            weights.push_back(w);
+        });
+        REQUIRE(weights.size() == s.size());
+        for(size_t i = 0; i < s.size(); ++i){
+            CHECK(weights[i] == weight(s[i], is_original));
+        }
+    }
+}
@@ -19,6 +19,8 @@ limitations under the License.
 
 #include <string>
 #include <iostream>
+#include <fstream>
+#include <cstdio>
 
 #include <Catch/catch.hpp>
 #include <json.hpp>
@@ -61,6 +63,7 @@ TEST_CASE( "serialize and deserialize output data of keyword match preprocessor"
     KeywordMatchPreprocessor<AsIsPreprocessor<string_type>>::output_type o1 = j1;
     CHECK(o1.text == o0.text);
     CHECK(o1.keywords == o0.keywords);
+    CHECK(o1.patterns.size() == o0.keywords.size());
 }
 
 TEST_CASE( "serialize and deserialize output data of weighted word sequence builder", "[serialization]" ) {
@@ -76,8 +79,8 @@ TEST_CASE( "serialize and deserialize output data of weighted word sequence buil
     WeightedSequenceBuilder<WordPreprocessor<string_type>, WordWeight>::output_type o1 = j1;
     REQUIRE(o1.size() == o0.size());
     for(size_t i = 0; i < o1.size(); ++i){
-        CHECK(o1[i].token.surface == o0[i].token.surface);
-        CHECK(o1[i].token.feature == o0[i].token.feature);
+        CHECK(o1[i].token.surface() == o0[i].token.surface());
+        CHECK(o1[i].token.feature() == o0[i].token.feature());
         CHECK(o1[i].weight == o0[i].weight);
     }
 }
@@ -99,3 +102,46 @@ TEST_CASE( "serialize and deserialize output data of weighted romaji sequence bu
         CHECK(o1[i].weight == o0[i].weight);
     }
 }
+
+TEST_CASE( "serialize and deserialize output data of weighted romaji sequence builder with quantized weights", "[serialization]" ) {
+    init_locale();
+
+    WeightedSequenceBuilder<RomajiPreprocessor, RomajiWeight, int16_t>::output_type o0 = {{L'T', 38}, {L'e', 90}};
+
+    json j0 = o0;
+    const std::string s = j0.dump();
+    CHECK(s == "[{\"t\":\"T\",\"w\":38},{\"t\":\"e\",\"w\":90}]");
+
+    json j1 = json::parse(s);
+    WeightedSequenceBuilder<RomajiPreprocessor, RomajiWeight, int16_t>::output_type o1 = j1;
+    REQUIRE(o1.size() == o0.size());
+    for(size_t i = 0; i < o1.size(); ++i){
+        CHECK(o1[i].token == o0[i].token);
+        CHECK(o1[i].weight == o0[i].weight);
+    }
+}
+
+TEST_CASE( "reject weights stored in another format", "[serialization]" ) {
+    init_locale();
+
+    WeightedSequenceBuilder<RomajiPreprocessor, RomajiWeight, int16_t>::output_type o;
+    CHECK_THROWS(o = json::parse("[{\"t\":\"T\",\"w\":0.3}]").get<decltype(o)>());
+    CHECK_THROWS(o = json::parse("[{\"t\":\"T\",\"w\":40000}]").get<decltype(o)>());
+
+    const std::string index_path = "./weight_format.tsv";
+    {
+        std::ofstream ofs(index_path);
+        ofs << weight_format_header<int16_t>() << std::endl;
+        ofs << "T\tT\t[{\"t\":\"T\",\"w\":38}]" << std::endl;
+    }
+    CHECK_NOTHROW(check_weight_format<int16_t>(index_path));
+    CHECK_THROWS(check_weight_format<int32_t>(index_path));
+    CHECK_THROWS(check_weight_format<double>(index_path));
+    {
+        std::ofstream ofs(index_path);
+        ofs << "T\tT\t[{\"t\":\"T\",\"w\":0.3}]" << std::endl;
+    }
+    CHECK_NOTHROW(check_weight_format<double>(index_path));
+    CHECK_THROWS(check_weight_format<int16_t>(index_path));
+    std::remove(index_path.c_str());
+}
@@ -90,6 +90,77 @@ TEST_CASE( "wstring to string", "[language]" ) {
     test_cast_string_wstring_string(L"このﾃｽﾄはcast_stringを実行します。", "このﾃｽﾄはcast_stringを実行します。");
 }
 
+TEST_CASE( "convert UTF-8 and wide strings without locales", "[language]" ) {
+    test_cast_string_string_wstring("\xf0\xa0\xae\xb7野家", L"\U00020BB7野家");
+    test_cast_string_wstring_string(L"\U00020BB7野家", "\xf0\xa0\xae\xb7野家");
+    test_cast_string_string_wstring("abcdefghijklmnopテストqrstuvwxyz0123456789", L"abcdefghijklmnopテストqrstuvwxyz0123456789");
+
+    // invalid sequences are replaced byte by byte
+    test_cast_string_string_wstring("a\xff" "b", L"a\xfffd" L"b");
+    test_cast_string_string_wstring("\xe3\x81", L"\xfffd\xfffd");
+    test_cast_string_string_wstring("\xc0\xaf", L"\xfffd\xfffd");
+    test_cast_string_string_wstring("\xed\xa0\x80", L"\xfffd\xfffd\xfffd");
+    test_cast_string_string_wstring("\x80\x80", L"\xfffd\xfffd");
+    test_cast_string_string_wstring("\xf0\x80\x80\x80テスト", L"\xfffd\xfffd\xfffd\xfffdテスト");
+
+    // surrogates and values out of Unicode are not encoded
+    test_cast_string_wstring_string(std::wstring(1, 0xD800) + L"a", "\xef\xbf\xbd" "a");
+    test_cast_string_wstring_string(std::wstring(1, 0x110000), "\xef\xbf\xbd");
+
+    // converted strings have no extra capacity
+    CHECK(cast_string<std::wstring>(std::string("日本語のテキストを変換したときの容量を確かめるための文字列")).capacity() == 29);
+    CHECK(cast_string<std::string>(std::wstring(L"abcdefghijklmnopqrstuvwxyz0123456789テスト")).capacity() == 45);
+
+    std::wstring all;
+    for(wchar_t c = 1; c <= 0x10FFFF; ++c){
+        if(c < 0xD800 || 0xDFFF < c){
+            all.push_back(c);
+        }
+    }
+    CHECK(cast_string<std::wstring>(cast_string<std::string>(all)) == all);
+
+    // ranges are converted into given strings
+    const std::string text = "範囲ABC";
+    std::wstring dest = L"long text to be overwritten";
+    cast_string(text.data(), text.data() + 6, dest);
+    CHECK(dest == L"範囲");
+    cast_string(text.data() + 6, text.data() + text.size(), dest);
+    CHECK(dest == L"ABC");
+    CHECK(cast_string<std::wstring>(text.data(), text.data()) == L"");
+    CHECK(cast_string<std::string>(text.data(), text.data() + 3) == "範");
+}
+
+TEST_CASE( "convert UTF-16 strings", "[language]" ) {
+    CHECK(cast_string<std::u16string>(std::string("テスト")) == u"テスト");
+    CHECK(cast_string<std::string>(std::u16string(u"テスト")) == "テスト");
+    CHECK(cast_string<std::u16string>(std::wstring(L"テスト")) == u"テスト");
+    CHECK(cast_string<std::wstring>(std::u16string(u"テスト")) == L"テスト");
+
+    // letters outside the BMP are surrogate pairs
+    CHECK(cast_string<std::u16string>(std::string("\xf0\xa0\xae\xb7野家")) == u"\U00020BB7野家");
+    CHECK(cast_string<std::u16string>(std::string("\xf0\xa0\xae\xb7野家")).size() == 4);
+    CHECK(cast_string<std::string>(std::u16string(u"\U00020BB7野家")) == "\xf0\xa0\xae\xb7野家");
+    CHECK(cast_string<std::wstring>(std::u16string(u"\U00020BB7野家")) == L"\U00020BB7野家");
+    CHECK(cast_string<std::u16string>(std::wstring(L"\U00020BB7野家")) == u"\U00020BB7野家");
+
+    // unpaired surrogates are replaced
+    CHECK(cast_string<std::string>(std::u16string(1, 0xD842) + u"a") == "\xef\xbf\xbd" "a");
+    CHECK(cast_string<std::wstring>(std::u16string(1, 0xDFB7)) == L"\xfffd");
+    CHECK(cast_string<std::u16string>(std::string("\xed\xa0\x80")) == u"\xfffd\xfffd\xfffd");
+    CHECK(cast_string<std::u16string>(std::string("\xf0\xa0\xae")) == u"\xfffd\xfffd\xfffd");
+
+    std::wstring all;
+    for(wchar_t c = 1; c <= 0x10FFFF; ++c){
+        if(c < 0xD800 || 0xDFFF < c){
+            all.push_back(c);
+        }
+    }
+    auto utf16 = cast_string<std::u16string>(all);
+    CHECK(cast_string<std::wstring>(utf16) == all);
+    CHECK(cast_string<std::u16string>(cast_string<std::string>(utf16)) == utf16);
+    CHECK(cast_string<std::u16string>(cast_string<std::string>(all)) == utf16);
+}
+
 TEST_CASE( "split strings", "[language]" ) {
     std::string line = "abc\tpqr\txyz";
     CHECK(split(line) == std::vector<std::string>({"abc", "pqr", "xyz"}));
@@ -0,0 +1,61 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <random>
+
+#include "Catch/catch.hpp"
+
+#include "suffix_automaton.hpp"
+
+using namespace resembla;
+
+TEST_CASE( "find substrings by suffix automaton", "[suffix_automaton]" ) {
+    SuffixAutomaton<std::string> automaton("abcbcab");
+    CHECK(automaton.contains(""));
+    CHECK(automaton.contains("a"));
+    CHECK(automaton.contains("bcb"));
+    CHECK(automaton.contains("cbca"));
+    CHECK(automaton.contains("abcbcab"));
+    CHECK_FALSE(automaton.contains("d"));
+    CHECK_FALSE(automaton.contains("aa"));
+    CHECK_FALSE(automaton.contains("abcbcabc"));
+
+    SuffixAutomaton<std::string> empty("");
+    CHECK(empty.contains(""));
+    CHECK_FALSE(empty.contains("a"));
+
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<int> letter(0, 2), length(0, 6);
+    auto random_string = [&](size_t n){
+        std::string s(n, 'a');
+        for(auto& c: s){
+            c = static_cast<char>('a' + letter(rng));
+        }
+        return s;
+    };
+    for(int k = 0; k < 20; ++k){
+        auto text = random_string(50);
+        SuffixAutomaton<std::string> a(text);
+        for(int i = 0; i < 100; ++i){
+            auto pattern = random_string(length(rng));
+            CHECK(a.contains(pattern) == (text.find(pattern) != std::string::npos));
+        }
+    }
+}
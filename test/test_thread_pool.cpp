@@ -0,0 +1,75 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <vector>
+#include <numeric>
+#include <stdexcept>
+
+#include "Catch/catch.hpp"
+
+#include "thread_pool.hpp"
+
+using namespace resembla;
+
+TEST_CASE( "run tasks on thread pool", "[thread]" ) {
+    ThreadPool pool(4);
+    CHECK(pool.size() == 4);
+
+    std::vector<std::future<int>> results;
+    for(int i = 0; i < 100; ++i){
+        results.push_back(pool.submit([i](){
+            return i * i;
+        }));
+    }
+    for(int i = 0; i < 100; ++i){
+        CHECK(pool.wait(results[i]) == i * i);
+    }
+
+    // nested tasks must not deadlock even if all workers are waiting
+    ThreadPool single(1);
+    auto outer = single.submit([&single](){
+        auto inner = single.submit([](){
+            return 1;
+        });
+        return single.wait(inner) + 1;
+    });
+    CHECK(single.wait(outer) == 2);
+}
+
+TEST_CASE( "parallel for on thread pool", "[thread]" ) {
+    ThreadPool pool(3);
+
+    for(size_t chunk_size: {1, 7, 1000, 2000}){
+        std::vector<int> values(1000, 0);
+        pool.parallel_for(values.size(), chunk_size, [&values](size_t begin, size_t end){
+            for(size_t i = begin; i < end; ++i){
+                values[i] += static_cast<int>(i);
+            }
+        });
+        std::vector<int> correct(values.size());
+        std::iota(std::begin(correct), std::end(correct), 0);
+        CHECK(values == correct);
+    }
+
+    CHECK_THROWS_AS(pool.parallel_for(100, 10, [](size_t begin, size_t){
+        if(begin == 50){
+            throw std::runtime_error("error");
+        }
+    }), const std::runtime_error&);
+}
@@ -0,0 +1,274 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "Catch/catch.hpp"
+
+#include "measure/weighted_edit_distance.hpp"
+
+using namespace resembla;
+
+struct WeightedChar
+{
+    char token;
+    double weight;
+};
+
+std::vector<WeightedChar> to_weighted(const std::string& s, double weight = 1.0)
+{
+    std::vector<WeightedChar> result;
+    for(auto c: s){
+        result.push_back({c, weight});
+    }
+    return result;
+}
+
+// sequence of up to max_length letters from 'a' to 'a' + max_letter with weights in [0.5, 2.0)
+std::vector<WeightedChar> random_weighted_sequence(std::mt19937& rng, int max_letter, int max_length)
+{
+    std::uniform_int_distribution<int> letter(0, max_letter), length(0, max_length);
+    std::uniform_real_distribution<double> weight(0.5, 2.0);
+    std::vector<WeightedChar> s(length(rng));
+    for(auto& c: s){
+        c = {static_cast<char>('a' + letter(rng)), weight(rng)};
+    }
+    return s;
+}
+
+TEST_CASE( "compute weighted edit distance", "[measure]" ) {
+    WeightedEditDistance<> wed;
+    CHECK(wed(to_weighted(""), to_weighted("")) == Approx(1.0));
+    CHECK(wed(to_weighted("a"), to_weighted("")) == Approx(0.0));
+    CHECK(wed(to_weighted("abc"), to_weighted("abc")) == Approx(1.0));
+    CHECK(wed(to_weighted("abc"), to_weighted("axc")) == Approx(4.0 / 6));
+    CHECK(wed(to_weighted("abc"), to_weighted("ab")) == Approx(4.0 / 5));
+    CHECK(wed(to_weighted("abc", 2.0), to_weighted("ab")) == Approx(1.0 - 2.0 / 8));
+}
+
+TEST_CASE( "compute weighted edit distance with minimum score", "[measure]" ) {
+    WeightedEditDistance<> wed;
+    CHECK(wed(to_weighted("abc"), to_weighted("axc"), 0.5) == Approx(4.0 / 6));
+    CHECK(wed(to_weighted("abc"), to_weighted("axc"), 4.0 / 6) == Approx(4.0 / 6));
+    CHECK(wed(to_weighted("abc"), to_weighted("axc"), 0.7) < 0.7);
+    CHECK(wed(to_weighted("abcdefgh"), to_weighted("a"), 0.5) < 0.5);
+
+    std::mt19937 rng(0);
+    for(int k = 0; k < 1000; ++k){
+        auto a = random_weighted_sequence(rng, 3, 12);
+        auto b = random_weighted_sequence(rng, 3, 12);
+        auto correct = wed.columnwise(a, b);
+        for(double min_score: {0.1, 0.3, 0.5, 0.7, 0.9}){
+            auto answer = wed(a, b, min_score);
+            if(correct >= min_score){
+                CHECK(answer == Approx(correct));
+            }
+            else{
+                CHECK(answer < min_score);
+                CHECK(answer >= correct - 1e-9);
+            }
+        }
+    }
+}
+
+TEST_CASE( "compute weighted edit distance along anti-diagonals", "[measure]" ) {
+    WeightedEditDistance<> wed;
+    CHECK(wed.diagonal(to_weighted(""), to_weighted("")) == Approx(1.0));
+    CHECK(wed.diagonal(to_weighted("a"), to_weighted("")) == Approx(0.0));
+    CHECK(wed.diagonal(to_weighted(""), to_weighted("a")) == Approx(0.0));
+    CHECK(wed.diagonal(to_weighted("abc"), to_weighted("axc")) == Approx(4.0 / 6));
+    CHECK(wed.diagonal(to_weighted("abc", 2.0), to_weighted("ab")) == Approx(1.0 - 2.0 / 8));
+
+    std::mt19937 rng(1);
+    for(int k = 0; k < 1000; ++k){
+        auto a = random_weighted_sequence(rng, 3, 40);
+        auto b = random_weighted_sequence(rng, 3, 40);
+        auto correct = wed.columnwise(a, b);
+        CHECK(std::abs(wed.diagonal(a, b) - correct) < 1e-5);
+        for(double min_score: {0.3, 0.6, 0.9}){
+            auto answer = wed.diagonal(a, b, min_score);
+            if(correct >= min_score){
+                CHECK(std::abs(answer - correct) < 1e-5);
+            }
+            else{
+                CHECK(answer < min_score + 1e-5);
+                CHECK(answer >= correct - 1e-5);
+            }
+        }
+    }
+}
+
+// costs between different letters are 0.5 or 1
+struct HalfCost
+{
+    double operator()(char a, char b) const
+    {
+        return a == b ? 0.0 : (a ^ b) & 1 ? 1.0 : 0.5;
+    }
+
+    double min_mismatch_cost() const
+    {
+        return 0.5;
+    }
+};
+
+TEST_CASE( "bound weighted edit distance by token histograms", "[measure]" ) {
+    WeightedEditDistance<> wed;
+    CHECK(wed.prepare(to_weighted("")).upper_bound(to_weighted(""), to_weighted("")) == Approx(1.0));
+    CHECK(wed.prepare(to_weighted("")).upper_bound(to_weighted(""), to_weighted("a")) == Approx(0.0));
+    CHECK(wed.prepare(to_weighted("a")).upper_bound(to_weighted("a"), to_weighted("")) == Approx(0.0));
+    CHECK(wed.prepare(to_weighted("abc")).upper_bound(to_weighted("abc"), to_weighted("cab")) == Approx(1.0));
+    CHECK(wed.prepare(to_weighted("aab")).upper_bound(to_weighted("aab"), to_weighted("abxy")) == Approx(1.0 - 3.0 / 7));
+
+    WeightedEditDistance<HalfCost> half;
+    std::mt19937 rng(3);
+    size_t num_bounded = 0;
+    for(int k = 0; k < 1000; ++k){
+        auto a = random_weighted_sequence(rng, 5, 15);
+        auto b = random_weighted_sequence(rng, 5, 15);
+        auto bound = wed.prepare(a).upper_bound(a, b);
+        CHECK(bound >= wed.columnwise(a, b) - 1e-9);
+        CHECK(half.prepare(a).upper_bound(a, b) >= half.columnwise(a, b) - 1e-9);
+        if(bound < 0.5){
+            ++num_bounded;
+        }
+    }
+    CHECK(num_bounded > 0);
+}
+
+template<typename weight_type>
+struct QuantizedChar
+{
+    char token;
+    weight_type weight;
+};
+
+template<typename weight_type>
+std::vector<QuantizedChar<weight_type>> quantize(const std::vector<WeightedChar>& s)
+{
+    std::vector<QuantizedChar<weight_type>> result;
+    for(const auto& c: s){
+        result.push_back({c.token, FixedPoint<weight_type>::quantize(c.weight)});
+    }
+    return result;
+}
+
+template<typename weight_type>
+void test_quantized_weights(double max_error)
+{
+    WeightedEditDistance<HalfCost> wed;
+
+    std::mt19937 rng(4);
+    for(int k = 0; k < 300; ++k){
+        auto a = random_weighted_sequence(rng, 5, 15);
+        auto b = random_weighted_sequence(rng, 5, 15);
+        auto qa = quantize<weight_type>(a);
+        auto qb = quantize<weight_type>(b);
+        auto correct = wed(qa, qb);
+        CHECK(std::abs(correct - wed(a, b)) <= max_error);
+        for(double min_score: {0.3, 0.5, 0.7}){
+            auto answer = wed(qa, qb, min_score);
+            if(correct >= min_score){
+                CHECK(answer == Approx(correct));
+            }
+            else{
+                CHECK(answer < min_score);
+            }
+            auto prepared = wed.prepare(qa);
+            CHECK(prepared.upper_bound(qa, qb) >= correct - 1e-9);
+        }
+    }
+}
+
+TEST_CASE( "compute weighted edit distance with quantized weights", "[measure]" ) {
+    CHECK(FixedPoint<int16_t>::quantize(1.0) == 128);
+    CHECK(FixedPoint<int16_t>::quantize(0.0) == 1);
+    CHECK(FixedPoint<int16_t>::quantize(1000.0) == 32767);
+    CHECK(FixedPoint<int32_t>::quantize(0.5) == 32768);
+
+    // weights are at least 0.5, so errors are at most 1 / (0.5 * WEIGHT_SCALE) + 0.5 / COST_SCALE
+    test_quantized_weights<int16_t>(1.0 / 64 + 0.5 / 1024);
+    test_quantized_weights<int32_t>(1.0 / 32768 + 0.5 / 65536);
+}
+
+template<typename Batch, typename sequence_type, typename Check>
+void test_batch(Batch& batch, const std::vector<sequence_type>& b, double min_score, Check check)
+{
+    for(size_t k = 0; k < b.size(); k += Batch::LANES){
+        size_t count = std::min(Batch::LANES, b.size() - k);
+        std::vector<const sequence_type*> group;
+        for(size_t l = 0; l < count; ++l){
+            group.push_back(&b[k + l]);
+        }
+        std::vector<double> scores(count);
+        batch(&group[0], count, min_score, &scores[0]);
+        for(size_t l = 0; l < count; ++l){
+            check(b[k + l], scores[l]);
+        }
+    }
+}
+
+TEST_CASE( "compute weighted edit distances in batches", "[measure]" ) {
+    WeightedEditDistance<HalfCost> wed;
+
+    std::mt19937 rng(5);
+    for(int k = 0; k < 30; ++k){
+        auto a = random_weighted_sequence(rng, 5, 20);
+        auto qa = quantize<int16_t>(a);
+        std::vector<std::vector<WeightedChar>> b;
+        std::vector<std::vector<QuantizedChar<int16_t>>> qb;
+        for(int l = 0; l < 40; ++l){
+            b.push_back(random_weighted_sequence(rng, 5, 20));
+            qb.push_back(quantize<int16_t>(b.back()));
+        }
+
+        // 16-bit weights are scored exactly
+        auto batch = wed.batch(qa);
+        for(double min_score: {0.0, 0.3, 0.6}){
+            test_batch(batch, qb, min_score, [&](const std::vector<QuantizedChar<int16_t>>& s, double score){
+                auto correct = wed.columnwise(qa, s);
+                if(correct >= min_score){
+                    CHECK(score == correct);
+                }
+                else{
+                    CHECK(score < min_score);
+                    CHECK(score >= correct);
+                }
+            });
+        }
+
+        BatchEditDistance<WeightedEditDistance<HalfCost>, WeightedTokenAccess, std::vector<WeightedChar>, FloatLane>
+            float_batch(wed, a);
+        for(double min_score: {0.0, 0.3, 0.6}){
+            test_batch(float_batch, b, min_score, [&](const std::vector<WeightedChar>& s, double score){
+                auto correct = wed.columnwise(a, s);
+                if(correct >= min_score){
+                    CHECK(std::abs(score - correct) < 1e-5);
+                }
+                else{
+                    CHECK(score < min_score + 1e-5);
+                    CHECK(score >= correct - 1e-5);
+                }
+            });
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/*
+Resembla
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+
+#include "Catch/catch.hpp"
+
+#include "string_util.hpp"
+#include "word.hpp"
+#include "measure/word_mismatch_cost.hpp"
+
+using namespace resembla;
+
+TEST_CASE( "intern words", "[word]" ) {
+    init_locale();
+
+    WordDictionary<string_type> dictionary;
+    auto w0 = dictionary.intern({L"橋", {L"名詞", L"一般", L"*", L"*", L"*", L"*", L"橋", L"ハシ", L"ハシ"}});
+    auto w1 = dictionary.intern({L"橋", {L"名詞", L"一般", L"*", L"*", L"*", L"*", L"橋", L"ハシ", L"ハシ"}});
+    auto w2 = dictionary.intern({L"端", {L"名詞", L"一般", L"*", L"*", L"*", L"*", L"端", L"ハシ", L"ハシ"}});
+    auto w3 = dictionary.intern({L"テスト", {L"名詞", L"サ変接続", L"*", L"*", L"*", L"*", L"*"}});
+
+    CHECK(w0.surface() == L"橋");
+    CHECK(w0.feature().size() == 9);
+    CHECK(w0.dictionary() == &dictionary);
+    CHECK(w0.is_same_surface(w1));
+    CHECK(&w0.feature() == &w1.feature());
+    CHECK_FALSE(w0.is_same_surface(w2));
+    CHECK(w0.pronunciation() == w2.pronunciation());
+    CHECK(w0.reading() != w2.reading());
+    CHECK(w0.is_homonym(w2));
+    CHECK(w3.reading() == nullptr);
+    CHECK(w3.pronunciation() == nullptr);
+    CHECK(*w3.signature() == L"ステト");
+
+    // known words refer to the dictionary, and unknown words own their strings
+    auto q0 = dictionary.find(L"橋", {L"名詞", L"一般", L"*", L"*", L"*", L"*", L"橋", L"ハシ", L"ハシ"});
+    CHECK(q0.dictionary() == &dictionary);
+    CHECK(&q0.surface() == &w0.surface());
+    CHECK(q0.pronunciation() == w0.pronunciation());
+    auto q1 = dictionary.find(L"箸", {L"名詞", L"一般", L"*", L"*", L"*", L"*", L"箸", L"ハシ", L"ハシ"});
+    CHECK(q1.dictionary() == nullptr);
+    CHECK(q1.surface() == L"箸");
+    CHECK(*q1.reading() == L"箸");
+    CHECK_FALSE(q1.is_same_surface(w0));
+    CHECK(q1.is_homonym(w0));
+    CHECK(w0.is_homonym(q1));
+
+    Word<string_type> w4(L"橋", {L"名詞", L"一般", L"*", L"*", L"*", L"*", L"橋", L"ハシ", L"ハシ"});
+    CHECK(w4.dictionary() == nullptr);
+    CHECK(w4.is_same_surface(w0));
+    CHECK(w0.is_same_surface(w4));
+
+    Word<string_type> w5;
+    CHECK(w5.surface().empty());
+    CHECK(w5.feature().empty());
+}
+
+TEST_CASE( "compute mismatch cost of words", "[word]" ) {
+    init_locale();
+
+    std::vector<string_type> feature = {L"名詞", L"一般", L"*", L"*", L"*", L"*", L"*", L"*", L"*"};
+    Word<string_type> w0(L"橋", {L"名詞", L"一般", L"*", L"*", L"*", L"*", L"橋", L"ハシ", L"ハシ"});
+    Word<string_type> w1(L"端", {L"名詞", L"一般", L"*", L"*", L"*", L"*", L"端", L"ハシ", L"ハシ"});
+    Word<string_type> w2(L"abc", feature);
+    Word<string_type> w3(L"cbd", feature);
+    Word<string_type> w4(L"xyz", feature);
+
+    WordMismatchCost<string_type> cost(0.1);
+    WordDictionary<string_type> dictionary;
+    auto i2 = dictionary.intern(w2);
+    auto i3 = dictionary.intern(w3);
+    CHECK(cost(i2, i3) == Approx(2.0 / 6));
+    CHECK(cost(i2, i3) == Approx(2.0 / 6));
+    CHECK(cost(i2, w3) == Approx(2.0 / 6));
+    CHECK(cost(w0, w0) == Approx(0.0));
+    CHECK(cost(w0, w1) == Approx(0.1));
+    CHECK(cost(w2, w3) == Approx(2.0 / 6));
+    CHECK(cost(w2, w3) == Approx(2.0 / 6));
+    CHECK(cost(w3, w2) == Approx(2.0 / 6));
+    CHECK(cost(w2, w4) == Approx(1.0));
+    CHECK(cost(w0, w2) == Approx(1.0));
+}
@@ -44,11 +44,11 @@ TEST_CASE( "parse a word", "[language]" ) {
     CHECK(words.size() == 1);
 
     auto& m = words[0];
-    CHECK(converter.to_bytes(m.surface) == "テスト");
-    CHECK(m.feature.size() == 9);
+    CHECK(converter.to_bytes(m.surface()) == "テスト");
+    CHECK(m.feature().size() == 9);
     std::vector<std::string> features = {"名詞", "サ変接続", "*", "*", "*", "*", "テスト", "テスト", "テスト"};
     for(size_t i = 0; i < features.size(); ++i){
-        CHECK(converter.to_bytes(m.feature[i]) == features[i]);
+        CHECK(converter.to_bytes(m.feature()[i]) == features[i]);
     }
 }
 
@@ -69,16 +69,16 @@ TEST_CASE( "parse words", "[language]" ) {
     CHECK(words.size() == 3);
 
     auto& m = words[0];
-    CHECK(converter.to_bytes(m.surface) == "私");
-    CHECK(converter.to_bytes(m.feature[0]) == "名詞");
+    CHECK(converter.to_bytes(m.surface()) == "私");
+    CHECK(converter.to_bytes(m.feature()[0]) == "名詞");
     m = words[1];
-    CHECK(converter.to_bytes(m.surface) == "は");
-    CHECK(converter.to_bytes(m.feature[0]) == "助詞");
+    CHECK(converter.to_bytes(m.surface()) == "は");
+    CHECK(converter.to_bytes(m.feature()[0]) == "助詞");
     m = words[2];
-    CHECK(converter.to_bytes(m.surface) == "考える");
-    CHECK(converter.to_bytes(m.feature[0]) == "動詞");
+    CHECK(converter.to_bytes(m.surface()) == "考える");
+    CHECK(converter.to_bytes(m.feature()[0]) == "動詞");
 
     for(auto i = words.begin(); i != words.end(); ++i){
-        CHECK(i->feature.size() == 9);
+        CHECK(i->feature().size() == 9);
     }
 }